@@ -0,0 +1,706 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <signal.h>
+#include <sys/prctl.h>
+#include <tr.hpp>
+
+
+namespace legacy {
+  // Parser shipped up to tr 1.3, kept as the baseline for comparison.
+  std::vector<tr::memory_region_t> map_memory_regions( const std::filesystem::path & maps_path ) {
+    std::vector<tr::memory_region_t> regions;
+    std::string                      line;
+    std::ifstream                    process_memory_map_fs( maps_path );
+
+    while ( std::getline( process_memory_map_fs, line ) ) {
+      tr::memory_region_t region;
+      std::size_t         cursor_position, previous_cursor_position = 0;
+
+      cursor_position          = line.find_first_of( '-' );
+      region.start             = std::stoul( line.substr( 0, cursor_position ), nullptr, 16 );
+      previous_cursor_position = cursor_position;
+      cursor_position          = line.find_first_of( ' ' );
+      region.end = std::stoul( line.substr( previous_cursor_position + 1, cursor_position ), nullptr, 16 );
+
+      region.readable   = line.substr( cursor_position + 1, 1 ) == "r";
+      region.writable   = line.substr( cursor_position + 2, 1 ) == "w";
+      region.executable = line.substr( cursor_position + 3, 1 ) == "x";
+      region.shared     = line.substr( cursor_position + 4, 1 ) != "p";
+
+      cursor_position += 6;
+      previous_cursor_position = cursor_position;
+      region.offset            = std::stoul( line.substr( previous_cursor_position, 8 ), nullptr, 16 );
+      cursor_position          = line.find_first_of( ' ', previous_cursor_position );
+      cursor_position++;
+      region.device_major = std::stol( line.substr( cursor_position, 2 ), nullptr, 16 );
+      cursor_position += 3;
+      region.device_minor = std::stol( line.substr( cursor_position, 2 ), nullptr, 16 );
+      cursor_position += 1;
+      region.inode = std::stol( line.substr( cursor_position + 2, 9 ), nullptr, 16 );
+
+      if ( line.find( ".so" ) != std::string::npos || line.find( '[' ) != std::string::npos ) {
+        region.special  = line.find( '[' ) != std::string::npos;
+        region.path     = std::filesystem::path { line.erase( 0, 73 ) };
+        region.filename = region.path.string( ).erase( 0, region.path.string( ).find_last_of( "/" ) + 1 );
+      }
+      regions.push_back( std::move( region ) );
+    }
+    return regions;
+  }
+
+  // PID lookup shipped up to tr 1.3.
+  std::optional<int> get_pid_by_name( std::string_view process_name ) {
+    for ( const auto & process : std::filesystem::directory_iterator( "/proc/" ) ) {
+      if ( !process.is_directory( ) )
+        continue;
+      if ( !tr::_internal::only_digits( process.path( ).string( ).erase( 0, 6 ) ) )
+        continue;
+
+      std::string   line;
+      std::ifstream process_name_fs( process.path( ) / "comm" );
+      if ( process_name_fs.is_open( ) ) {
+        std::getline( process_name_fs, line );
+        if ( line == process_name )
+          return std::stoi( process.path( ).string( ).erase( 0, 6 ) );
+      }
+    }
+    return std::nullopt;
+  }
+} // namespace legacy
+
+namespace {
+  using clock_type = std::chrono::steady_clock;
+
+  bool json_output = false;
+
+  // Set when a benchmark observes wrong results, benchmark then exits with non-zero status.
+  bool results_mismatch = false;
+
+  /**
+   * Print section title of human readable output.
+   */
+  void section( const char * title ) {
+    if ( !json_output )
+      printf( "%s\n", title );
+  }
+
+  /**
+   * Print single measurement, either as table row or as one JSON object per
+   * line (--json), which is stable between versions and meant for diffing.
+   * Names and units are plain identifiers, so they are not escaped.
+   */
+  void report( const std::string & benchmark,
+               const std::string & variant,
+               const std::string & parameter,
+               double              value,
+               const char *        unit ) {
+    if ( json_output ) {
+      printf( "{\"benchmark\":\"%s\",\"variant\":\"%s\",\"parameter\":\"%s\","
+              "\"value\":%.6g,\"unit\":\"%s\"}\n",
+              benchmark.c_str( ),
+              variant.c_str( ),
+              parameter.c_str( ),
+              value,
+              unit );
+    } else {
+      printf( "  %-44s %-16s %16.3f %s\n", variant.c_str( ), parameter.c_str( ), value, unit );
+    }
+    fflush( stdout );
+  }
+
+  /**
+   * Call repeatedly until at least minimum time elapsed.
+   * @return seconds per call.
+   */
+  template <typename F>
+  double seconds_per_call( F && call, std::chrono::milliseconds minimum = std::chrono::milliseconds( 200 ) ) {
+    std::size_t          iterations = 0;
+    const auto           begin      = clock_type::now( );
+    clock_type::duration elapsed;
+    do {
+      call( );
+      iterations++;
+      elapsed = clock_type::now( ) - begin;
+    } while ( elapsed < minimum );
+    return std::chrono::duration<double>( elapsed ).count( ) / static_cast<double>( iterations );
+  }
+
+  /**
+   * Memory layouts of spawned children.
+   */
+  enum class layout_t {
+    // Many single page anonymous regions.
+    small_regions,
+    // Single large populated heap with planted signatures and markers.
+    huge_heap,
+    // Many .so file mappings, each with r--, r-x and rw- segments.
+    libraries
+  };
+
+  /**
+   * Layout reported by the child once it is built.
+   */
+  struct layout_info_t {
+    std::uintptr_t heap;
+    std::size_t    heap_size;
+  };
+
+  // Planted into huge_heap every signature_stride bytes, marker every marker_stride bytes.
+  constexpr std::uint8_t  signature[]       = { 0xDE, 0xAD, 0xBE, 0xEF, 0x13, 0x37, 0xC0, 0xDE };
+  constexpr const char *  signature_pattern = "DE AD BE EF ?? 37 C0 DE";
+  constexpr std::size_t   signature_offset  = 64;
+  constexpr std::size_t   signature_stride  = 1 << 20;
+  constexpr std::uint32_t marker            = 0x6e627274;
+  constexpr std::size_t   marker_offset     = 128;
+  constexpr std::size_t   marker_stride     = 1 << 16;
+
+  /**
+   * Count values of given width planted every stride bytes from offset on into heap of size bytes.
+   */
+  constexpr std::size_t
+  planted( std::size_t size, std::size_t offset, std::size_t stride, std::size_t width ) {
+    return size < offset + width ? 0 : ( size - offset - width ) / stride + 1;
+  }
+
+  /**
+   * Child process with known memory layout, killed on destruction.
+   * Children re-execute the benchmark binary with --child, so they share its
+   * modules but not its heap.
+   */
+  class child_t {
+  private:
+    pid_t                 m_pid  = -1;
+    layout_info_t         m_info = { };
+    std::filesystem::path m_directory;
+
+    [[noreturn]] static void run( const char *                  name,
+                                  layout_t                      layout,
+                                  std::size_t                   size,
+                                  const std::filesystem::path & directory,
+                                  int                           ready ) {
+      prctl( PR_SET_NAME, name );
+      prctl( PR_SET_PDEATHSIG, SIGKILL );
+
+      const auto    page = static_cast<std::size_t>( sysconf( _SC_PAGESIZE ) );
+      layout_info_t info { };
+      switch ( layout ) {
+        case layout_t::small_regions: {
+          const auto base = static_cast<std::uint8_t *>(
+              mmap( nullptr, size * page, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0 ) );
+          // Alternating protection keeps the kernel from merging neighbouring pages.
+          for ( std::size_t i = 0; i < size; i += 2 )
+            mprotect( base + i * page, page, PROT_READ );
+          info = { reinterpret_cast<std::uintptr_t>( base ), size * page };
+          break;
+        }
+        case layout_t::huge_heap: {
+          constexpr int flags = MAP_PRIVATE | MAP_ANONYMOUS | MAP_POPULATE;
+          const auto    base =
+              static_cast<std::uint8_t *>( mmap( nullptr, size, PROT_READ | PROT_WRITE, flags, -1, 0 ) );
+          std::uint64_t state = 0x9E3779B97F4A7C15;
+          for ( std::size_t offset = 0; offset + sizeof( state ) <= size; offset += sizeof( state ) ) {
+            state ^= state << 13;
+            state ^= state >> 7;
+            state ^= state << 17;
+            std::memcpy( base + offset, &state, sizeof( state ) );
+          }
+          for ( auto at = signature_offset; at + sizeof( signature ) <= size; at += signature_stride )
+            std::memcpy( base + at, signature, sizeof( signature ) );
+          for ( auto at = marker_offset; at + sizeof( marker ) <= size; at += marker_stride )
+            std::memcpy( base + at, &marker, sizeof( marker ) );
+          info = { reinterpret_cast<std::uintptr_t>( base ), size };
+          break;
+        }
+        case layout_t::libraries: {
+          std::filesystem::create_directories( directory );
+          constexpr int protections[] = { PROT_READ, PROT_READ | PROT_EXEC, PROT_READ | PROT_WRITE };
+          for ( std::size_t i = 0; i < size; i++ ) {
+            const auto path = directory / ( "libtrbench" + std::to_string( i ) + ".so" );
+            const int  fd   = open( path.c_str( ), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0600 );
+            if ( fd == -1 || ftruncate( fd, static_cast<off_t>( 3 * page ) ) == -1 )
+              _exit( 1 );
+            const auto base = static_cast<std::uint8_t *>(
+                mmap( nullptr, 3 * page, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0 ) );
+            for ( std::size_t segment = 0; segment < 3; segment++ )
+              mmap( base + segment * page,
+                    page,
+                    protections[ segment ],
+                    MAP_PRIVATE | MAP_FIXED,
+                    fd,
+                    static_cast<off_t>( segment * page ) );
+            close( fd );
+          }
+          break;
+        }
+      }
+
+      if ( write( ready, &info, sizeof( info ) ) != sizeof( info ) )
+        _exit( 1 );
+      for ( ;; )
+        pause( );
+    }
+
+  public:
+    /**
+     * Entry point of re-executed child.
+     * @param arguments name, layout, size, directory and ready descriptor.
+     */
+    [[noreturn]] static void run( char ** arguments ) {
+      run( arguments[ 0 ],
+           static_cast<layout_t>( std::strtoul( arguments[ 1 ], nullptr, 10 ) ),
+           std::strtoull( arguments[ 2 ], nullptr, 10 ),
+           arguments[ 3 ],
+           static_cast<int>( std::strtol( arguments[ 4 ], nullptr, 10 ) ) );
+    }
+
+    /**
+     * Spawn child and wait until its layout is built.
+     * @param name comm of the child, at most 15 characters.
+     * @param layout memory layout.
+     * @param size number of pages (small_regions), heap bytes (huge_heap) or
+     * number of shared objects (libraries).
+     */
+    child_t( const char * name, layout_t layout, std::size_t size ) {
+      m_directory = std::filesystem::temp_directory_path( ) /
+                    ( "trbench-" + std::to_string( getpid( ) ) + "-" + std::string( name ) );
+
+      int ready[ 2 ];
+      if ( pipe( ready ) == -1 )
+        return;
+
+      // Arguments are prepared before fork, child only closes and executes.
+      const std::string arguments[] = { std::to_string( static_cast<int>( layout ) ),
+                                        std::to_string( size ),
+                                        m_directory.string( ),
+                                        std::to_string( ready[ 1 ] ) };
+      const char *      argv[]      = { "trbench",
+                                        "--child",
+                                        name,
+                                        arguments[ 0 ].c_str( ),
+                                        arguments[ 1 ].c_str( ),
+                                        arguments[ 2 ].c_str( ),
+                                        arguments[ 3 ].c_str( ),
+                                        nullptr };
+
+      m_pid = fork( );
+      if ( m_pid == 0 ) {
+        close( ready[ 0 ] );
+        execv( "/proc/self/exe", const_cast<char * const *>( argv ) );
+        _exit( 1 );
+      }
+      close( ready[ 1 ] );
+      if ( m_pid > 0 && read( ready[ 0 ], &m_info, sizeof( m_info ) ) != sizeof( m_info ) ) {
+        fprintf( stderr, "child %s failed to build its layout\n", name );
+        kill( m_pid, SIGKILL );
+        waitpid( m_pid, nullptr, 0 );
+        m_pid = -1;
+      }
+      close( ready[ 0 ] );
+    }
+
+    ~child_t( ) {
+      if ( m_pid > 0 ) {
+        kill( m_pid, SIGKILL );
+        waitpid( m_pid, nullptr, 0 );
+      }
+      std::error_code error;
+      std::filesystem::remove_all( m_directory, error );
+    }
+
+    child_t( const child_t & )             = delete;
+    child_t & operator=( const child_t & ) = delete;
+
+    [[nodiscard]] bool          valid( ) const noexcept { return m_pid > 0; }
+    [[nodiscard]] pid_t         pid( ) const noexcept { return m_pid; }
+    [[nodiscard]] layout_info_t info( ) const noexcept { return m_info; }
+  };
+
+  /**
+   * Thread counts scans are measured with: powers of two up to hardware concurrency.
+   */
+  std::vector<std::size_t> thread_counts( ) {
+    const std::size_t        hardware = std::max( 1u, std::thread::hardware_concurrency( ) );
+    std::vector<std::size_t> counts;
+    for ( std::size_t count = 1; count < hardware; count *= 2 )
+      counts.push_back( count );
+    counts.push_back( hardware );
+    return counts;
+  }
+
+  /**
+   * Write maps file resembling JIT-heavy process: many anonymous
+   * regions interleaved with shared object segments.
+   */
+  std::filesystem::path write_synthetic_maps( std::size_t rows ) {
+    const auto path = std::filesystem::temp_directory_path( ) / "trbench_maps.txt";
+    FILE *     file = fopen( path.c_str( ), "w" );
+
+    std::uint64_t address = 0x7f0000000000;
+    for ( std::size_t row = 0; row < rows; row++ ) {
+      const std::uint64_t size = 0x1000 * ( 1 + row % 16 );
+      if ( row % 4 == 0 ) {
+        fprintf( file,
+                 "%012lx-%012lx r-xp %08lx fd:01 %lu                   /usr/lib/x86_64-linux-gnu/libjit%zu.so\n",
+                 address,
+                 address + size,
+                 row * 0x1000,
+                 1000000 + row / 4,
+                 row / 64 );
+      } else {
+        fprintf( file, "%012lx-%012lx rw-p 00000000 00:00 0 \n", address, address + size );
+      }
+      address += size;
+    }
+    fclose( file );
+    return path;
+  }
+
+  template <typename F> double regions_per_second( F && parse ) {
+    std::size_t regions = 0;
+    const auto  seconds = seconds_per_call( [ & ] { regions = parse( ).size( ); } );
+    return static_cast<double>( regions ) / seconds;
+  }
+
+  void bench_maps_parsing( ) {
+    constexpr std::size_t rows   = 20000;
+    const auto            path   = write_synthetic_maps( rows );
+    const auto            param  = std::to_string( rows ) + "_rows";
+
+    section( "maps parsing" );
+    std::string buffer;
+    const auto  before = regions_per_second( [ & ] { return legacy::map_memory_regions( path ); } );
+    const auto  after  = regions_per_second( [ & ] {
+      if ( !tr::_internal::read_file( path.c_str( ), buffer ) )
+        return std::vector<tr::memory_region_t> { };
+      return tr::_internal::parse_memory_regions( buffer );
+    } );
+    const auto  self   = regions_per_second( [ & ] {
+      return tr::_internal::map_memory_regions( getpid( ), buffer );
+    } );
+    report( "maps", "legacy_getline_substr", param, before, "regions/s" );
+    report( "maps", "single_buffer_parser", param, after, "regions/s" );
+    report( "maps", "proc_self_maps", "self", self, "regions/s" );
+
+    // Heap footprint per region: memory_region_t keeps two heap strings for mapped
+    // files, snapshot keeps fixed width columns plus one copy of every distinct path.
+    (void)tr::_internal::read_file( path.c_str( ), buffer );
+    const auto regions = tr::_internal::parse_memory_regions( buffer );
+    std::size_t aos    = regions.capacity( ) * sizeof( tr::memory_region_t );
+    for ( const auto & region : regions )
+      aos += region.path.native( ).capacity( ) + region.filename.capacity( );
+
+    tr::region_snapshot_t snapshot;
+    tr::_internal::for_each_maps_entry( buffer, [ & ]( const tr::_internal::maps_entry_t & entry ) {
+      snapshot.push_back( entry );
+    } );
+    std::size_t soa = snapshot.size( ) * ( 4 * sizeof( std::uint64_t ) + 2 * sizeof( std::uint32_t ) + 1 );
+    for ( std::uint32_t id = 0; id < snapshot.path_count( ); id++ )
+      soa += sizeof( std::string ) + snapshot.path( id ).size( );
+
+    const auto aos_per_region = static_cast<double>( aos ) / static_cast<double>( regions.size( ) );
+    const auto soa_per_region = static_cast<double>( soa ) / static_cast<double>( snapshot.size( ) );
+    report( "maps_footprint", "memory_region_t", param, aos_per_region, "bytes/region" );
+    report( "maps_footprint", "region_snapshot_t", param, soa_per_region, "bytes/region" );
+    std::filesystem::remove( path );
+
+    // Maps of live processes through process_t.
+    const std::tuple<const char *, layout_t, std::size_t> layouts[] = {
+      { "small_regions", layout_t::small_regions, 16384 },
+      { "huge_heap", layout_t::huge_heap, std::size_t { 256 } << 20 },
+      { "libraries", layout_t::libraries, 512 },
+    };
+    for ( const auto & [ name, layout, size ] : layouts ) {
+      const child_t child( "trbench-maps", layout, size );
+      if ( !child.valid( ) )
+        continue;
+
+      tr::process_t process( child.pid( ) );
+      process.map_memory_regions( );
+      const auto count = std::to_string( process.get_memory_regions( ).size( ) ) + "_regions";
+
+      tr::region_snapshot_t snapshot;
+      const auto            map     = seconds_per_call( [ & ] { process.map_memory_regions( ); } );
+      const auto            refresh = seconds_per_call( [ & ] { (void)process.refresh_memory_regions( ); } );
+      const auto            columns = seconds_per_call( [ & ] {
+        (void)process.map_memory_regions( snapshot );
+      } );
+      report( "maps_process", std::string( "map_memory_regions/" ) + name, count, 1e3 * map, "ms" );
+      report( "maps_process", std::string( "refresh_memory_regions/" ) + name, count, 1e3 * refresh, "ms" );
+      report( "maps_process", std::string( "region_snapshot/" ) + name, count, 1e3 * columns, "ms" );
+    }
+  }
+
+  /**
+   * Copy executable segments of shared objects loaded into this process,
+   * they are the realistic haystack for code signatures.
+   */
+  std::vector<std::uint8_t> collect_text_segments( ) {
+    std::vector<std::uint8_t> text;
+    for ( const auto & region : tr::_internal::map_memory_regions( getpid( ) ) ) {
+      if ( !region.readable || !region.executable || region.filename.find( ".so" ) == std::string::npos )
+        continue;
+      const auto data = reinterpret_cast<const std::uint8_t *>( region.start );
+      text.insert( text.end( ), data, data + ( region.end - region.start ) );
+    }
+    return text;
+  }
+
+  template <typename F>
+  void bench_kernel( const char * signature_text, const char * name, std::size_t bytes, F && kernel ) {
+    const auto seconds = seconds_per_call( kernel );
+    report( "pattern_kernel",
+            std::string( name ) + "/" + signature_text,
+            std::to_string( bytes ) + "_bytes",
+            static_cast<double>( bytes ) / seconds / 1e9,
+            "GB/s" );
+  }
+
+  void bench_pattern_matching( ) {
+    const auto text = collect_text_segments( );
+    section( "pattern matching kernels (.so text of this process)" );
+
+    constexpr const char * signatures[] = { "48 8B ?? ?? E8",
+                                            "E8 ?? ?? ?? ?? 48 89 C7 E8 ?? ?? ?? ??",
+                                            "0F 0B C3 CC CC" };
+    for ( const auto signature_text : signatures ) {
+      const auto pattern = *tr::pattern_t::parse( signature_text );
+      const auto count   = [ & ]( std::size_t & matches ) {
+        return [ &matches ]( std::size_t ) {
+          matches++;
+          return true;
+        };
+      };
+
+      bench_kernel( signature_text, "scalar", text.size( ), [ & ] {
+        std::size_t matches = 0;
+        tr::_internal::match_pattern_scalar( text.data( ), text.size( ), pattern, 0, count( matches ) );
+        return matches;
+      } );
+#ifdef TRICKSTER_X86_SIMD
+      bench_kernel( signature_text, "sse2", text.size( ), [ & ] {
+        std::size_t matches = 0;
+        tr::_internal::match_pattern_sse2( text.data( ), text.size( ), pattern, count( matches ) );
+        return matches;
+      } );
+      if ( tr::_internal::cpu_has_avx2( ) ) {
+        bench_kernel( signature_text, "avx2", text.size( ), [ & ] {
+          std::size_t matches = 0;
+          tr::_internal::match_pattern_avx2( text.data( ), text.size( ), pattern, count( matches ) );
+          return matches;
+        } );
+      }
+#endif
+    }
+  }
+
+  void bench_pid_lookup( ) {
+    // Name that does not exist forces the full /proc scan.
+    constexpr auto missing = "trbench-missing";
+
+    std::size_t processes = 0;
+    tr::_internal::for_each_pid( [ & ]( int ) { return ++processes != 0; } );
+    const auto param = std::to_string( processes ) + "_processes";
+
+    section( "pid lookup" );
+    const auto before  = seconds_per_call( [ & ] { (void)legacy::get_pid_by_name( missing ); } );
+    const auto after   = seconds_per_call( [ & ] { (void)tr::_internal::get_pids_by_name( missing ); } );
+    const auto cmdline = seconds_per_call( [ & ] {
+      (void)tr::_internal::get_pids_by_name( missing, tr::process_match_t::cmdline );
+    } );
+    const auto exe     = seconds_per_call( [ & ] {
+      (void)tr::_internal::get_pids_by_name( missing, tr::process_match_t::exe );
+    } );
+    report( "pid_lookup", "legacy_directory_iterator", param, 1e3 * before, "ms" );
+    report( "pid_lookup", "getdents64_comm", param, 1e3 * after, "ms" );
+    report( "pid_lookup", "getdents64_cmdline", param, 1e3 * cmdline, "ms" );
+    report( "pid_lookup", "getdents64_exe", param, 1e3 * exe, "ms" );
+
+    // Existing process is found as soon as /proc order reaches it.
+    const child_t child( "trbench-pid", layout_t::small_regions, 2 );
+    if ( child.valid( ) ) {
+      const auto found = seconds_per_call( [ & ] { (void)tr::_internal::get_pid_by_name( "trbench-pid" ); } );
+      report( "pid_lookup", "get_pid_by_name_found", param, 1e3 * found, "ms" );
+    }
+  }
+
+  const char * backend_name( tr::io_backend_t backend ) {
+    switch ( backend ) {
+      case tr::io_backend_t::proc_mem: return "proc_mem";
+      case tr::io_backend_t::ptrace: return "ptrace";
+      default: return "vm_readv";
+    }
+  }
+
+  void bench_reads_writes( ) {
+    constexpr std::size_t heap_size = std::size_t { 64 } << 20;
+    constexpr std::size_t accesses  = 4096;
+
+    const child_t child( "trbench-io", layout_t::huge_heap, heap_size );
+    if ( !child.valid( ) )
+      return;
+
+    // Scattered 8 byte aligned addresses across the heap, in random order.
+    std::mt19937_64             random( 42 );
+    std::vector<std::uintptr_t> addresses( accesses );
+    for ( auto & address : addresses )
+      address = child.info( ).heap + ( random( ) % ( heap_size / 8 ) ) * 8;
+    std::vector<std::uint64_t> values( accesses );
+
+    section( "reads and writes (64 MiB heap, 4096 scattered 8 byte values)" );
+    for ( const auto backend : { tr::io_backend_t::vm_readv, tr::io_backend_t::proc_mem } ) {
+      const tr::process_t process( child.pid( ), backend );
+      if ( process.get_io_backend( ) != backend )
+        continue;
+      const std::string name = backend_name( backend );
+
+      const auto read = seconds_per_call( [ & ] {
+        for ( std::size_t i = 0; i < accesses; i++ )
+          values[ i ] = process.read_memory<std::uint64_t>( addresses[ i ] )->data;
+      } );
+      const auto write = seconds_per_call( [ & ] {
+        for ( std::size_t i = 0; i < accesses; i++ )
+          (void)process.write_memory( addresses[ i ], values[ i ] );
+      } );
+      report( "read", name + "/read_memory", "1", accesses / read, "values/s" );
+      report( "write", name + "/write_memory", "1", accesses / write, "values/s" );
+
+      std::vector<tr::read_entry_t> entries( accesses );
+      for ( std::size_t i = 0; i < accesses; i++ )
+        entries[ i ] = { addresses[ i ], &values[ i ], sizeof( std::uint64_t ) };
+
+      tr::write_batch_t batch;
+      for ( const std::size_t batch_size : { 16, 256, 4096 } ) {
+        const auto scatter = seconds_per_call( [ & ] {
+          for ( std::size_t i = 0; i < accesses; i += batch_size )
+            (void)process.read_scatter( entries.data( ) + i, batch_size, nullptr );
+        } );
+        const auto batched = seconds_per_call( [ & ] {
+          for ( std::size_t i = 0; i < accesses; i += batch_size ) {
+            batch.clear( );
+            for ( std::size_t j = i; j < i + batch_size; j++ )
+              batch.add( addresses[ j ], values[ j ] );
+            (void)process.write_batch( batch );
+          }
+        } );
+        const auto param = std::to_string( batch_size );
+        report( "read", name + "/read_scatter", param, accesses / scatter, "values/s" );
+        report( "write", name + "/write_batch", param, accesses / batched, "values/s" );
+      }
+
+      std::vector<std::uint8_t> buffer( heap_size );
+      // Whole heap read in entries of given size.
+      constexpr std::size_t sizes[] = { 4 << 10, 64 << 10, 1 << 20, heap_size };
+      for ( const auto size : sizes ) {
+        const auto                    count = heap_size / size;
+        std::vector<tr::read_entry_t> chunks( count );
+        for ( std::size_t i = 0; i < count; i++ )
+          chunks[ i ] = { child.info( ).heap + i * size, buffer.data( ) + i * size, size };
+
+        const auto seconds = seconds_per_call( [ & ] {
+          (void)process.read_scatter( chunks.data( ), count, nullptr );
+        } );
+        const auto param   = std::to_string( size ) + "_bytes";
+        report( "read_bulk", name + "/read_scatter", param, heap_size / seconds / 1e9, "GB/s" );
+      }
+    }
+  }
+
+  void bench_scans( ) {
+    section( "scans (huge heap children, pattern and value scan of all regions)" );
+    const auto pattern = *tr::pattern_t::parse( signature_pattern );
+
+    for ( const std::size_t megabytes : { 16, 64, 256 } ) {
+      const child_t child( "trbench-scan", layout_t::huge_heap, megabytes << 20 );
+      if ( !child.valid( ) )
+        continue;
+
+      tr::process_t process( child.pid( ) );
+      process.map_memory_regions( );
+
+      const auto heap = child.info( ).heap, heap_size = child.info( ).heap_size;
+      const auto signatures = planted( heap_size, signature_offset, signature_stride, sizeof( signature ) );
+      const auto markers    = planted( heap_size, marker_offset, marker_stride, sizeof( marker ) );
+
+      std::size_t readable = 0, writable = 0;
+      for ( const auto & region : process.get_memory_regions( ) ) {
+        readable += region.readable ? region.end - region.start : 0;
+        writable += region.readable && region.writable ? region.end - region.start : 0;
+      }
+
+      for ( const auto threads : thread_counts( ) ) {
+        tr::thread_pool_t pool( threads );
+        const auto        param = std::to_string( megabytes ) + "MiB/" + std::to_string( threads ) + "t";
+
+        tr::scan_options_t options;
+        options.pool = &pool;
+        std::vector<std::uintptr_t> matches;
+        const auto pattern_seconds = seconds_per_call( [ & ] {
+          matches = process.find_pattern( pattern, options );
+        } );
+
+        tr::value_scan_options_t value_options;
+        value_options.pool = &pool;
+        tr::value_scanner_t<std::uint32_t> scanner( process, value_options );
+        const auto                         value_seconds = seconds_per_call( [ & ] {
+          (void)scanner.first_scan( tr::scan_condition_t::equal, marker );
+        } );
+
+        // Binary itself contains the signature and marker constants, only hits in the heap are planted ones.
+        const auto in_heap = [ & ]( const std::vector<std::uintptr_t> & addresses ) {
+          return static_cast<std::size_t>(
+              std::count_if( addresses.begin( ), addresses.end( ), [ & ]( std::uintptr_t address ) {
+                return address >= heap && address < heap + heap_size;
+              } ) );
+        };
+        const auto found_signatures = in_heap( matches ), found_markers = in_heap( scanner.addresses( ) );
+        if ( found_signatures != signatures || found_markers != markers ) {
+          fprintf( stderr,
+                   "scan %s: %zu of %zu signatures and %zu of %zu markers found in the heap\n",
+                   param.c_str( ),
+                   found_signatures,
+                   signatures,
+                   found_markers,
+                   markers );
+          results_mismatch = true;
+        }
+
+        // Match counts are reported too, so regressions in correctness show up next to speed.
+        report( "scan", "find_pattern", param, readable / pattern_seconds / 1e9, "GB/s" );
+        report( "scan", "find_pattern_matches", param, static_cast<double>( found_signatures ), "matches" );
+        report( "scan", "value_first_scan", param, writable / value_seconds / 1e9, "GB/s" );
+        report( "scan", "value_first_scan_candidates", param, static_cast<double>( found_markers ), "count" );
+      }
+    }
+  }
+} // namespace
+
+int main( int argc, char ** argv ) {
+  if ( argc == 7 && std::string_view( argv[ 1 ] ) == "--child" )
+    child_t::run( argv + 2 );
+
+  constexpr std::pair<const char *, void ( * )( )> benchmarks[] = {
+    { "maps", bench_maps_parsing }, { "pattern", bench_pattern_matching }, { "pid", bench_pid_lookup },
+    { "io", bench_reads_writes },   { "scan", bench_scans },
+  };
+
+  std::vector<std::string_view> selected;
+  for ( int i = 1; i < argc; i++ ) {
+    const std::string_view argument = argv[ i ];
+    if ( argument == "--json" ) {
+      json_output = true;
+    } else if ( argument == "--help" || argument == "-h" ) {
+      printf( "usage: %s [--json] [maps|pattern|pid|io|scan]...\n", argv[ 0 ] );
+      return 0;
+    } else {
+      selected.push_back( argument );
+    }
+  }
+
+  for ( const auto & [ name, run ] : benchmarks ) {
+    if ( selected.empty( ) || std::find( selected.begin( ), selected.end( ), name ) != selected.end( ) )
+      run( );
+  }
+  return results_mismatch ? 1 : 0;
+}
@@ -2,22 +2,63 @@
 #define TRICKSTER
 
 #include <algorithm>
+#include <array>
 #include <assert.h>
+#include <atomic>
+#include <charconv>
+#include <chrono>
+#include <condition_variable>
 #include <cstdint>
+#include <deque>
 #include <filesystem>
 #include <fstream>
+#include <functional>
+#include <future>
 #include <iostream>
+#include <limits>
+#include <memory>
+#include <mutex>
 #include <optional>
 #include <sstream>
 #include <string>
 #include <string_view>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
 
+#include <cctype>
 #include <cerrno>
+#include <climits>
+#include <cstddef>
 #include <cstring>
 
 #include <any>
+#include <dirent.h>
+#include <elf.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/ptrace.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
 #include <sys/types.h>
 #include <sys/uio.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#if defined( __x86_64__ ) && ( defined( __GNUC__ ) || defined( __clang__ ) ) && !defined( TRICKSTER_NO_SIMD )
+#define TRICKSTER_X86_SIMD
+#include <immintrin.h>
+#endif
+
+#if defined( __linux__ ) && __has_include( <linux/io_uring.h> ) && !defined( TRICKSTER_NO_IO_URING )
+#define TRICKSTER_IO_URING
+#include <linux/io_uring.h>
+#endif
 
 #define tr_assert( condition, message ) assert( condition && message )
 /**
@@ -105,356 +146,8406 @@ namespace tr {
   };
 
   /**
-   * internal tr's namespace.
-   * DO NOT use outside tr.hpp
-   * if you dont have to.
+   * Difference between two consecutive memory region maps.
+   * Indices refer to the regions after refresh.
    */
-  namespace _internal {
-    enum class log_levels_t : std::uint8_t { info = 0, error };
-    template <log_levels_t L, typename... Args> void log( std::string_view format, Args... args ) {
-      std::string output { tr_string( "[tr] " ) };
-      output.append( format );
-      if constexpr ( L == log_levels_t::error ) {
-        fprintf( stderr, output.append( tr_string( "\n" ) ).c_str( ), args... );
-      } else if constexpr ( L == log_levels_t::info ) {
-        fprintf( stdout, output.append( tr_string( "\n" ) ).c_str( ), args... );
-      }
-    }
-
+  struct memory_region_diff_t {
     /**
-     * Memory read result.
+     * Regions starting at address where no region started before.
      */
-    template <typename T> struct read_result_t {
-      T           data;
-      std::size_t bytes_requested, bytes_read;
-      bool        partial_read = bytes_requested != bytes_read;
-    };
+    std::vector<std::size_t> added;
 
     /**
-     * Memory write result.
+     * Regions starting at the same address as before, but with different
+     * end, permissions, offset, device, inode or path.
      */
-    template <typename T> struct write_result_t {
-      std::size_t bytes_requested, bytes_written;
-      bool        partial_write = bytes_requested != bytes_written;
-    };
+    std::vector<std::size_t> changed;
 
     /**
-     * Check if string contains only digits.
-     * @param string string to check
-     * @return true if only digits, false otherwise
+     * Regions starting at address where no region starts anymore.
      */
-    [[nodiscard]] inline bool only_digits( std::string_view string ) {
-      return std::all_of( string.begin( ), string.end( ), ::isdigit );
-    }
+    std::vector<memory_region_t> removed;
 
     /**
-     * Get process id by name.
-     * @param process_name name of the process.
-     * @return id of the process or std::nullopt if function fails.
+     * Check if maps did not change.
+     * @return state of statement above.
      */
-    [[nodiscard]] inline std::optional<int> get_pid_by_name( std::string_view process_name ) {
-      tr_assert( !process_name.empty( ), "Process name is 0 length." );
+    [[nodiscard]] bool empty( ) const noexcept {
+      return added.empty( ) && changed.empty( ) && removed.empty( );
+    }
+  };
 
-      for ( const auto & process : std::filesystem::directory_iterator( tr_string( "/proc/" ) ) ) {
-        if ( !process.is_directory( ) )
-          continue;
+  /**
+   * Single entry of batched memory read.
+   * Data from remote address is copied to the buffer owned by caller.
+   */
+  struct read_entry_t {
+    std::uintptr_t address;
+    void *         buffer;
+    std::size_t    size;
+  };
 
-        if ( !_internal::only_digits( process.path( ).string( ).erase( 0, 6 ) ) )
-          continue;
+  /**
+   * Range of memory [start, end), page aligned unless clipped to the bounds
+   * of a requested range.
+   */
+  struct page_range_t {
+    std::uintptr_t start, end;
+  };
 
-        std::string   line;
-        std::ifstream process_name_fs( process.path( ) / tr_string( "comm" ) );
-        if ( process_name_fs.is_open( ) ) {
-          std::getline( process_name_fs, line );
-          if ( line == process_name )
-            return std::stoi( process.path( ).string( ).erase( 0, 6 ) );
-        }
-      }
+  /**
+   * Pointer chain, resolves to [[[base + offsets[0]] + offsets[1]] ...] + offsets[n - 1],
+   * where [x] is pointer read from address x. Chain without offsets resolves to base.
+   */
+  struct pointer_chain_t {
+    std::uintptr_t              base;
+    std::vector<std::ptrdiff_t> offsets;
+  };
 
-#ifdef TRICKSTER_DEBUG
-      _internal::log<_internal::log_levels_t::error>(
-          tr_string( "Could not get '%s' process id. Consider checking if it exists." ),
-          process_name.data( ) );
-#endif
-      return std::nullopt;
-    }
+  /**
+   * Mechanism process_t uses to access process memory.
+   */
+  enum class io_backend_t : std::uint8_t {
+    /**
+     * process_vm_readv / process_vm_writev, fastest for scattered accesses.
+     */
+    vm_readv = 0,
 
     /**
-     * Get process memory regions.
-     * @param pid process id.
-     * @return std::vector containing memory regions as its entries, it is good
-     * to check if returned vector is not empty because it means that process
-     * with id provided in function call does not exist.
+     * pread / pwrite on /proc/$PID/mem kept open for the lifetime of process_t.
+     * Contiguous entries are transferred with single preadv / pwritev. Writes
+     * succeed even on pages that are not writable by the process itself.
      */
-    [[nodiscard]] inline std::vector<memory_region_t> map_memory_regions( const int pid ) {
-      std::vector<memory_region_t> regions;
-      for ( const auto & process : std::filesystem::directory_iterator( tr_string( "/proc/" ) ) ) {
-        if ( !process.is_directory( ) )
-          continue;
+    proc_mem,
 
-        if ( !_internal::only_digits( process.path( ).string( ).erase( 0, 6 ) ) )
-          continue;
+    /**
+     * PTRACE_PEEKDATA / PTRACE_POKEDATA, last resort when neither of the
+     * above is permitted. Process is stopped for the duration of each transfer.
+     * Transfers of one process_t are serialized because process can have a
+     * single tracer, so parallel scans on this backend run sequentially.
+     */
+    ptrace
+  };
+
+  /**
+   * Which property of the process is compared with the name when looking it up.
+   */
+  enum class process_match_t : std::uint8_t {
+    /**
+     * /proc/$PID/comm, kernel truncates it to 15 characters.
+     */
+    comm = 0,
+
+    /**
+     * Filename of the first argument in /proc/$PID/cmdline.
+     */
+    cmdline,
 
-        if ( process.path( ).string( ).erase( 0, 6 ) == std::to_string( pid ) ) {
-          std::string   line;
-          std::ifstream process_memory_map_fs( process.path( ) / tr_string( "maps" ) );
+    /**
+     * Filename of the /proc/$PID/exe executable.
+     */
+    exe
+  };
 
-          if ( process_memory_map_fs.is_open( ) ) {
-            // TODO: Find faster and better way to do it.
-            while ( std::getline( process_memory_map_fs, line ) ) {
-              memory_region_t region;
-              std::size_t     cursor_position, previous_cursor_position = 0;
+  /**
+   * internal tr's namespace.
+   * DO NOT use outside tr.hpp
+   * if you dont have to.
+   */
+  namespace _internal {
+    enum class log_levels_t : std::uint8_t { info = 0, error, none };
 
-              cursor_position = line.find_first_of( '-' );
+#ifdef TRICKSTER_DEBUG
+    /**
+     * Bounded lock-free ring of formatted log messages, drained to stdout and
+     * stderr by a background thread, so logging never blocks on I/O. Messages
+     * pushed while the ring is full are dropped and counted.
+     */
+    class log_queue_t {
+    public:
+      static constexpr std::size_t message_size = 256;
+      static constexpr std::size_t capacity     = 1024;
 
-              region.start = std::stoul( line.substr( 0, cursor_position ), nullptr, 16 );
+      /**
+       * Minimal level of logged messages.
+       */
+      std::atomic<std::uint8_t> level { 0 };
 
-              previous_cursor_position = cursor_position;
+      /**
+       * Messages logged per call site, thread and second, 0 for no limit.
+       */
+      std::atomic<std::uint32_t> rate_limit { 16 };
 
-              cursor_position = line.find_first_of( ' ' );
+    private:
+      struct slot_t {
+        std::atomic<std::size_t> sequence;
+        log_levels_t             level;
+        std::size_t              length;
+        char                     text[ message_size ];
+      };
 
-              region.end =
-                  std::stoul( line.substr( previous_cursor_position + 1, cursor_position ), nullptr, 16 );
+      const std::unique_ptr<slot_t[]> m_slots;
+      alignas( 64 ) std::atomic<std::size_t> m_head { 0 };
+      alignas( 64 ) std::atomic<std::size_t> m_tail { 0 };
+      std::atomic<std::uint64_t> m_dropped { 0 };
 
-              region.readable   = line.substr( cursor_position + 1, 1 ) == tr_string( "r" );
-              region.writable   = line.substr( cursor_position + 2, 1 ) == tr_string( "w" );
-              region.executable = line.substr( cursor_position + 3, 1 ) == tr_string( "x" );
-              region.shared     = line.substr( cursor_position + 4, 1 ) != tr_string( "p" );
+      std::mutex              m_output_mutex;
+      std::thread             m_thread;
+      std::mutex              m_thread_mutex;
+      std::condition_variable m_thread_signal;
+      bool                    m_stop = false;
 
-              cursor_position += 6;
-              previous_cursor_position = cursor_position;
+    public:
+      log_queue_t( ) : m_slots( new slot_t[ capacity ] ) {
+        for ( std::size_t i = 0; i < capacity; i++ )
+          m_slots[ i ].sequence.store( i, std::memory_order_relaxed );
 
-              region.offset = std::stoul( line.substr( previous_cursor_position, 8 ), nullptr, 16 );
+        m_thread = std::thread( [ this ] {
+          std::unique_lock<std::mutex> lock( m_thread_mutex );
+          while ( !m_stop ) {
+            lock.unlock( );
+            drain( );
+            lock.lock( );
+            m_thread_signal.wait_for( lock, std::chrono::milliseconds( 10 ), [ this ] { return m_stop; } );
+          }
+        } );
+      }
 
-              cursor_position = line.find_first_of( ' ', previous_cursor_position );
+      ~log_queue_t( ) {
+        {
+          std::lock_guard<std::mutex> lock( m_thread_mutex );
+          m_stop = true;
+        }
+        m_thread_signal.notify_all( );
+        m_thread.join( );
+        drain( );
+      }
 
-              cursor_position++;
+      log_queue_t( const log_queue_t & )             = delete;
+      log_queue_t & operator=( const log_queue_t & ) = delete;
 
-              region.device_major = std::stol( line.substr( cursor_position, 2 ), nullptr, 16 );
+      /**
+       * Enqueue formatted message, never blocks.
+       * @param level level of the message, selects output stream.
+       * @param text message text, truncated to message_size.
+       * @param length length of the text.
+       * @return false if the ring is full and message was dropped.
+       */
+      bool push( log_levels_t level, const char * text, std::size_t length ) {
+        auto position = m_head.load( std::memory_order_relaxed );
+        for ( ;; ) {
+          auto &     slot       = m_slots[ position % capacity ];
+          const auto sequence   = slot.sequence.load( std::memory_order_acquire );
+          const auto difference = static_cast<std::ptrdiff_t>( sequence - position );
+          if ( difference == 0 ) {
+            if ( m_head.compare_exchange_weak( position, position + 1, std::memory_order_relaxed ) ) {
+              slot.level  = level;
+              slot.length = std::min( length, message_size );
+              std::memcpy( slot.text, text, slot.length );
+              slot.sequence.store( position + 1, std::memory_order_release );
+              return true;
+            }
+          } else if ( difference < 0 ) {
+            m_dropped.fetch_add( 1, std::memory_order_relaxed );
+            return false;
+          } else {
+            position = m_head.load( std::memory_order_relaxed );
+          }
+        }
+      }
 
-              cursor_position += 3; // 4 Because we want to skip the `:` device separator
+      /**
+       * Write all enqueued messages, called periodically by the drain thread.
+       */
+      void drain( ) {
+        std::lock_guard<std::mutex> lock( m_output_mutex );
+        for ( auto position = m_tail.load( std::memory_order_relaxed );; position++ ) {
+          auto & slot = m_slots[ position % capacity ];
+          if ( slot.sequence.load( std::memory_order_acquire ) != position + 1 ) {
+            m_tail.store( position, std::memory_order_relaxed );
+            break;
+          }
+          fwrite( slot.text, 1, slot.length, slot.level == log_levels_t::error ? stderr : stdout );
+          slot.sequence.store( position + capacity, std::memory_order_release );
+        }
 
-              region.device_minor = std::stol( line.substr( cursor_position, 2 ), nullptr, 16 );
+        if ( const auto dropped = m_dropped.exchange( 0, std::memory_order_relaxed ); dropped != 0 )
+          fprintf( stderr,
+                   tr_string( "[tr] %llu log messages dropped.\n" ),
+                   static_cast<unsigned long long>( dropped ) );
+        fflush( stdout );
+        fflush( stderr );
+      }
+    };
 
-              cursor_position += 1;
-              previous_cursor_position = cursor_position;
+    /**
+     * Get process wide log queue, its drain thread starts with the first message.
+     * @return log queue.
+     */
+    inline log_queue_t & log_queue( ) {
+      static log_queue_t queue;
+      return queue;
+    }
 
-              region.inode = std::stol( line.substr( cursor_position + 2, 9 ), nullptr, 16 );
+    /**
+     * Count message of call site against the rate limit of the calling thread.
+     * Sites share 64 slots, site that finds all its probed slots taken evicts
+     * the least recently used one and suppressed count of the evicted site is
+     * reported with the next logged message.
+     * @param file file of the call site.
+     * @param line line of the call site.
+     * @param limit messages allowed per second.
+     * @param suppressed set to number of messages suppressed in the previous second.
+     * @return true if message should be logged.
+     */
+    inline bool
+    log_rate_check( const char * file, std::uint32_t line, std::uint32_t limit, std::uint32_t & suppressed ) {
+      struct site_t {
+        const char *  file;
+        std::uint32_t line;
+        std::int64_t  second;
+        std::uint32_t count, suppressed;
+      };
+      constexpr std::size_t               probes = 4;
+      thread_local std::array<site_t, 64> sites { };
+      thread_local std::uint32_t          evicted = 0;
 
-              if ( line.find( tr_string( ".so" ) ) != std::string::npos ||
-                   line.find( '[' ) != std::string::npos ) {
-                region.special = line.find( '[' ) != std::string::npos;
+      const auto second = std::chrono::duration_cast<std::chrono::seconds>(
+                              std::chrono::steady_clock::now( ).time_since_epoch( ) )
+                              .count( );
+      const auto hash   = ( reinterpret_cast<std::uintptr_t>( file ) >> 3 ) * 31 + line;
 
-                region.path     = std::filesystem::path { line.erase( 0, 73 ) };
-                region.filename = region.path.string( ).erase(
-                    0, region.path.string( ).find_last_of( tr_string( "/" ) ) + 1 );
-              }
+      site_t * state = nullptr;
+      for ( std::size_t probe = 0; probe < probes && !state; probe++ ) {
+        auto & candidate = sites[ ( hash + probe ) % sites.size( ) ];
+        if ( candidate.file == file && candidate.line == line )
+          state = &candidate;
+      }
 
-              regions.push_back( std::move( region ) );
-            }
-            return regions;
-          }
+      if ( !state ) {
+        state = &sites[ hash % sites.size( ) ];
+        for ( std::size_t probe = 1; probe < probes; probe++ ) {
+          auto & candidate = sites[ ( hash + probe ) % sites.size( ) ];
+          if ( candidate.second < state->second )
+            state = &candidate;
         }
+        evicted += state->suppressed;
+        *state = { file, line, second, 0, 0 };
+      } else if ( state->second != second ) {
+        suppressed = state->suppressed;
+        *state     = { file, line, second, 0, 0 };
+      }
+
+      if ( state->count++ < limit ) {
+        suppressed += evicted;
+        evicted = 0;
+        return true;
       }
+      state->suppressed++;
+      return false;
+    }
+#endif
+
+    /**
+     * Format string of log message with its call site, which is the key of the
+     * rate limit. Format string can not be the key, with xorstr it is
+     * decrypted into temporary at the call site.
+     */
+    struct log_site_t {
+      const char *  format;
+      const char *  file;
+      std::uint32_t line;
+
+      log_site_t( const char *  format,
+                  const char *  file = __builtin_FILE( ),
+                  std::uint32_t line = __builtin_LINE( ) ) noexcept
+          : format( format ), file( file ), line( line ) { }
+    };
+
+    /**
+     * Log printf style message. Message is formatted into thread local buffer
+     * and handed to the drain thread, messages below the runtime level and
+     * repeated messages over the rate limit are discarded before formatting.
+     * Compiles to nothing without TRICKSTER_DEBUG.
+     * @param site printf format string, converted together with its call site.
+     * @param args format arguments.
+     */
+    template <log_levels_t L, typename... Args> void log( log_site_t site, Args... args ) {
 #ifdef TRICKSTER_DEBUG
-      _internal::log<_internal::log_levels_t::error>(
-          tr_string( "Could not get memory regions of process with %i id. Consider checking if it exists." ),
-          pid );
+      const auto format = site.format;
+      auto & queue = log_queue( );
+      if ( static_cast<std::uint8_t>( L ) < queue.level.load( std::memory_order_relaxed ) )
+        return;
+
+      std::uint32_t suppressed = 0;
+      const auto    limit      = queue.rate_limit.load( std::memory_order_relaxed );
+      if ( limit != 0 && !log_rate_check( site.file, site.line, limit, suppressed ) )
+        return;
+
+      constexpr std::size_t prefix_size = 5;
+      thread_local char     buffer[ log_queue_t::message_size ];
+      std::memcpy( buffer, tr_string( "[tr] " ), prefix_size );
+
+      const auto  available = sizeof( buffer ) - prefix_size - 1;
+      std::size_t length;
+      if constexpr ( sizeof...( Args ) == 0 ) {
+        length = std::min( std::strlen( format ), available );
+        std::memcpy( buffer + prefix_size, format, length );
+      } else {
+        const auto written = snprintf( buffer + prefix_size, available + 1, format, args... );
+        length             = written < 0 ? 0 : std::min( static_cast<std::size_t>( written ), available );
+      }
+      length += prefix_size;
+      buffer[ length++ ] = '\n';
+
+      if ( suppressed != 0 ) {
+        char       notice[ 64 ];
+        const auto notice_length = snprintf(
+            notice, sizeof( notice ), tr_string( "[tr] %u similar messages suppressed.\n" ), suppressed );
+        queue.push( L, notice, static_cast<std::size_t>( notice_length ) );
+      }
+      queue.push( L, buffer, length );
+#else
+      (void)site;
+      ( (void)args, ... );
 #endif
-      return {};
     }
   } // namespace _internal
 
+  using log_levels_t = _internal::log_levels_t;
+
   /**
-   * tr's utilities namespace.
+   * Set minimal level of logged messages, log_levels_t::none silences logging.
+   * No-op without TRICKSTER_DEBUG.
+   * @param level minimal level.
    */
-  namespace utils {
+  inline void set_log_level( log_levels_t level ) {
+#ifdef TRICKSTER_DEBUG
+    _internal::log_queue( ).level.store( static_cast<std::uint8_t>( level ), std::memory_order_relaxed );
+#else
+    (void)level;
+#endif
+  }
 
-    // TODO: Error checking
+  /**
+   * Limit messages logged by single call site on single thread, repeats over
+   * the limit are suppressed and their count is logged the next second.
+   * No-op without TRICKSTER_DEBUG.
+   * @param per_second messages allowed per second, 0 disables limiting.
+   */
+  inline void set_log_rate_limit( std::uint32_t per_second ) {
+#ifdef TRICKSTER_DEBUG
+    _internal::log_queue( ).rate_limit.store( per_second, std::memory_order_relaxed );
+#else
+    (void)per_second;
+#endif
+  }
+
+  /**
+   * Write all enqueued log messages now instead of waiting for the drain thread.
+   * No-op without TRICKSTER_DEBUG.
+   */
+  inline void flush_log( ) {
+#ifdef TRICKSTER_DEBUG
+    _internal::log_queue( ).drain( );
+#endif
+  }
+
+  /**
+   * Operations measured when tr is compiled with TRICKSTER_METRICS.
+   */
+  enum class metric_operation_t : std::uint8_t {
     /**
-     * Utility function for getting list of shared objects
-     * loaded into process memory without duplicate entries.
-     * @param regions mapped memory regions where modules are located.
-     * @return prettified list of loaded modules.
+     * Reads of process memory through the I/O backend.
      */
-    [[nodiscard]] std::vector<std::string> get_modules( const std::vector<memory_region_t> & regions ) {
-      std::vector<std::string> modules;
+    read = 0,
 
-      modules.reserve( regions.size( ) );
+    /**
+     * Writes of process memory through the I/O backend.
+     */
+    write,
 
-      for ( auto & region : regions )
-        if ( region.filename.find( tr_string( ".so" ) ) != std::string::npos )
-          modules.push_back( std::move( region.filename ) );
-        else
-          continue;
+    /**
+     * Reads and parsing of /proc/$PID/maps.
+     */
+    maps,
 
-      std::sort( modules.begin( ), modules.end( ) );
-      modules.erase( std::unique( modules.begin( ), modules.end( ) ), modules.end( ) );
+    /**
+     * Lookups of process ids by name.
+     */
+    pid_lookup
+  };
 
-      modules.shrink_to_fit( );
+  /**
+   * Log-linear latency histogram in nanoseconds (HDR style). Every power of
+   * two range is split into sub_buckets equal buckets, so recorded values
+   * keep relative error below 1 / sub_buckets.
+   */
+  struct latency_histogram_t {
+    static constexpr std::size_t sub_bucket_bits = 3;
+    static constexpr std::size_t sub_buckets     = std::size_t { 1 } << sub_bucket_bits;
+    static constexpr std::size_t bucket_count    = sub_buckets * 40;
 
-      return modules;
+    std::array<std::uint64_t, bucket_count> counts { };
+    std::uint64_t                           count = 0, sum = 0, max = 0;
+
+    /**
+     * Get bucket of value, values over the range land in the last bucket.
+     * @param value value in nanoseconds.
+     * @return bucket index.
+     */
+    [[nodiscard]] static constexpr std::size_t bucket_of( std::uint64_t value ) noexcept {
+      if ( value < sub_buckets )
+        return static_cast<std::size_t>( value );
+      const std::size_t exponent = 63 - static_cast<std::size_t>( __builtin_clzll( value ) );
+      const std::size_t index    = ( exponent - sub_bucket_bits + 1 ) * sub_buckets +
+                                ( ( value >> ( exponent - sub_bucket_bits ) ) & ( sub_buckets - 1 ) );
+      return std::min( index, bucket_count - 1 );
     }
-  } // namespace utils
 
-  class process_t {
-  private:
-    const int                    m_id;
-    const std::string            m_name;
-    std::vector<memory_region_t> m_regions;
+    /**
+     * Get smallest value of bucket.
+     * @param bucket bucket index.
+     * @return value in nanoseconds.
+     */
+    [[nodiscard]] static constexpr std::uint64_t lower_bound( std::size_t bucket ) noexcept {
+      if ( bucket < sub_buckets )
+        return bucket;
+      const auto exponent = bucket / sub_buckets + sub_bucket_bits - 1;
+      return ( sub_buckets + bucket % sub_buckets ) << ( exponent - sub_bucket_bits );
+    }
 
-  public:
-    constexpr static int invalid = -1;
+    /**
+     * Get value below which the given fraction of recorded values lies.
+     * @param quantile fraction in [0, 1], e.g. 0.99.
+     * @return upper bound of the bucket holding the quantile, in nanoseconds.
+     */
+    [[nodiscard]] std::uint64_t percentile( double quantile ) const noexcept {
+      if ( count == 0 )
+        return 0;
+      // Nearest rank, ceil( quantile * count ) clamped to [1, count].
+      const auto    position   = quantile * static_cast<double>( count );
+      auto          rank       = static_cast<std::uint64_t>( position );
+      std::uint64_t cumulative = 0;
+      rank                     = std::clamp<std::uint64_t>( rank + ( rank < position ), 1, count );
+      for ( std::size_t bucket = 0; bucket < bucket_count; bucket++ ) {
+        cumulative += counts[ bucket ];
+        if ( cumulative >= rank )
+          return std::min( lower_bound( bucket + 1 ) - 1, max );
+      }
+      return max;
+    }
 
-    explicit process_t( std::string_view process_name )
-        : m_id( _internal::get_pid_by_name( process_name ).value_or( invalid ) ), m_name( process_name ) {};
+    /**
+     * Get mean of recorded values.
+     * @return mean in nanoseconds.
+     */
+    [[nodiscard]] double mean( ) const noexcept {
+      return count ? static_cast<double>( sum ) / static_cast<double>( count ) : 0;
+    }
+  };
 
+  /**
+   * Counters of single measured operation.
+   */
+  struct operation_metrics_t {
     /**
-     * Check if process is valid.
-     * @return state of statement above.
+     * Number of operations, e.g. read_memory or batched read calls.
      */
-    [[nodiscard]] bool is_valid( ) const { return m_id != invalid; }
+    std::uint64_t calls;
 
     /**
-     * Get process id.
-     * @return process id
+     * Number of system calls issued and bytes they requested and transferred.
      */
-    [[nodiscard]] int get_id( ) const { return m_id; }
+    std::uint64_t syscalls, bytes_requested, bytes_transferred;
 
     /**
-     * Get process name.
-     * @return process name.
+     * System calls that transferred less than requested and ones that failed.
      */
-    [[nodiscard]] std::string_view get_name( ) const noexcept {
-      tr_assert( is_valid( ), tr_string( "Process is invalid." ) );
-      return m_name;
-    }
+    std::uint64_t partial, failures;
 
     /**
-     * Get process memory regions.
-     * @return std::vector containing memory regions as its entries, it is good
-     * to check if returned vector is not empty because it means that process
-     * with id provided in function call does not exist.
+     * Failed system calls by errno, in errno order.
      */
-    [[nodiscard]] const std::vector<memory_region_t> & get_memory_regions( ) const noexcept {
-      tr_assert( is_valid( ), tr_string( "Process is invalid." ) );
-      return m_regions;
-    }
+    std::vector<std::pair<int, std::uint64_t>> errors;
 
     /**
-     * Map memory regions.
+     * Latency of whole operations.
      */
-    void map_memory_regions( ) {
-      tr_assert( is_valid( ), tr_string( "Process is invalid." ) );
-      m_regions = _internal::map_memory_regions( m_id );
+    latency_histogram_t latency;
+  };
+
+  /**
+   * Point in time copy of counters of all operations.
+   */
+  struct metrics_snapshot_t {
+    std::array<operation_metrics_t, 4> operations { };
+
+    [[nodiscard]] const operation_metrics_t & operator[]( metric_operation_t operation ) const noexcept {
+      return operations[ static_cast<std::size_t>( operation ) ];
     }
+  };
 
+  namespace _internal {
     /**
-     * Read process memory.
-     * @param address starting address
-     * @param size read size (default: sizeof(T))
-     * @return read_result_t struct. See tr.hpp (line 127)
-     *
-     * NOTE: process_vm_readv return value may be less than the total number
-     * of requested bytes, if a partial write occurred. Define TRICKSTER_DEBUG
-     * to see if this situation (the one described above) happens.
-     *
-     * TODO: return bool (bytes requested == bytes written)
+     * Counters of single operation, updated with relaxed atomics so they can
+     * be shared by all threads using the same process_t.
      */
+    class operation_counters_t {
+    private:
+      static constexpr std::size_t errno_count = 134;
 
-    // clang-format off
-    template <typename T>
-    std::optional<_internal::read_result_t<T>> 
-    read_memory( std::uintptr_t address, std::size_t size = sizeof( T ) ) const {
-      // clang-format on
-      tr_assert( is_valid( ), tr_string( "Process is invalid." ) );
+      std::atomic<std::uint64_t> m_calls { 0 }, m_syscalls { 0 }, m_bytes_requested { 0 },
+          m_bytes_transferred { 0 }, m_partial { 0 }, m_failures { 0 };
+      std::array<std::atomic<std::uint64_t>, errno_count> m_errors { };
 
-      T     buffer {};
-      iovec local[ 1 ], remote[ 1 ];
+      std::array<std::atomic<std::uint64_t>, latency_histogram_t::bucket_count> m_latency { };
+      std::atomic<std::uint64_t> m_latency_sum { 0 }, m_latency_max { 0 };
 
-      local[ 0 ].iov_base  = std::addressof( buffer );
-      local[ 0 ].iov_len   = size;
-      remote[ 0 ].iov_base = (void *)( address );
-      remote[ 0 ].iov_len  = size;
+    public:
+      /**
+       * Record system call.
+       * @param requested bytes requested.
+       * @param result return value of the call, -1 on failure.
+       * @param error errno of failed call.
+       */
+      void syscall( std::size_t requested, ssize_t result, int error ) noexcept {
+        m_syscalls.fetch_add( 1, std::memory_order_relaxed );
+        m_bytes_requested.fetch_add( requested, std::memory_order_relaxed );
+        if ( result < 0 ) {
+          failure( error );
+          return;
+        }
+        m_bytes_transferred.fetch_add( static_cast<std::uint64_t>( result ), std::memory_order_relaxed );
+        if ( static_cast<std::size_t>( result ) < requested )
+          m_partial.fetch_add( 1, std::memory_order_relaxed );
+      }
 
-      const std::size_t result = process_vm_readv( m_id, local, 1, remote, 1, 0 );
+      /**
+       * Record failure of operation not mapped to single system call.
+       * @param error errno of the failure.
+       */
+      void failure( int error ) noexcept {
+        m_failures.fetch_add( 1, std::memory_order_relaxed );
+        m_errors[ error > 0 && static_cast<std::size_t>( error ) < errno_count ? error : 0 ].fetch_add(
+            1, std::memory_order_relaxed );
+      }
 
-      if ( result == -1 ) {
-#ifdef TRICKSTER_DEBUG
-        _internal::log<_internal::log_levels_t::error>(
-            tr_string( "Memory reading (at %p) failed with error code: %i, Message: %s" ),
-            address,
-            errno,
-            strerror( errno ) );
-#endif
-        return std::nullopt;
+      /**
+       * Record bytes transferred by operation not mapped to single system call.
+       * @param bytes number of bytes.
+       */
+      void transferred( std::size_t bytes ) noexcept {
+        m_bytes_transferred.fetch_add( bytes, std::memory_order_relaxed );
       }
-#ifdef TRICKSTER_DEBUG
-      if ( result != size ) {
-        _internal::log<_internal::log_levels_t::info>( tr_string( "Partial read occured." ) );
+
+      /**
+       * Record completed operation.
+       * @param elapsed latency of the operation.
+       */
+      void call( std::chrono::nanoseconds elapsed ) noexcept {
+        const auto value = static_cast<std::uint64_t>( std::max<std::int64_t>( elapsed.count( ), 0 ) );
+        m_calls.fetch_add( 1, std::memory_order_relaxed );
+        m_latency[ latency_histogram_t::bucket_of( value ) ].fetch_add( 1, std::memory_order_relaxed );
+        m_latency_sum.fetch_add( value, std::memory_order_relaxed );
+
+        auto max = m_latency_max.load( std::memory_order_relaxed );
+        while ( value > max && !m_latency_max.compare_exchange_weak( max, value, std::memory_order_relaxed ) )
+          ;
       }
-#endif
-      return _internal::read_result_t<T> { buffer, size, result };
+
+      /**
+       * Copy counters, concurrent updates may be partially included.
+       * @return counters.
+       */
+      [[nodiscard]] operation_metrics_t snapshot( ) const {
+        operation_metrics_t metrics { };
+        metrics.calls             = m_calls.load( std::memory_order_relaxed );
+        metrics.syscalls          = m_syscalls.load( std::memory_order_relaxed );
+        metrics.bytes_requested   = m_bytes_requested.load( std::memory_order_relaxed );
+        metrics.bytes_transferred = m_bytes_transferred.load( std::memory_order_relaxed );
+        metrics.partial           = m_partial.load( std::memory_order_relaxed );
+        metrics.failures          = m_failures.load( std::memory_order_relaxed );
+
+        for ( std::size_t error = 0; error < errno_count; error++ ) {
+          if ( const auto count = m_errors[ error ].load( std::memory_order_relaxed ); count != 0 )
+            metrics.errors.emplace_back( static_cast<int>( error ), count );
+        }
+
+        for ( std::size_t bucket = 0; bucket < latency_histogram_t::bucket_count; bucket++ ) {
+          metrics.latency.counts[ bucket ] = m_latency[ bucket ].load( std::memory_order_relaxed );
+          metrics.latency.count += metrics.latency.counts[ bucket ];
+        }
+        metrics.latency.sum = m_latency_sum.load( std::memory_order_relaxed );
+        metrics.latency.max = m_latency_max.load( std::memory_order_relaxed );
+        return metrics;
+      }
+
+      /**
+       * Zero all counters.
+       */
+      void reset( ) noexcept {
+        for ( auto counter : { &m_calls, &m_syscalls, &m_bytes_requested, &m_bytes_transferred, &m_partial,
+                               &m_failures, &m_latency_sum, &m_latency_max } )
+          counter->store( 0, std::memory_order_relaxed );
+        for ( auto & counter : m_errors )
+          counter.store( 0, std::memory_order_relaxed );
+        for ( auto & counter : m_latency )
+          counter.store( 0, std::memory_order_relaxed );
+      }
+    };
+
+    /**
+     * Counters of all operations of single process_t.
+     */
+    struct metrics_t {
+      std::array<operation_counters_t, 4> operations;
+
+      operation_counters_t & operator[]( metric_operation_t operation ) noexcept {
+        return operations[ static_cast<std::size_t>( operation ) ];
+      }
+    };
+
+    /**
+     * Records latency of operation on destruction.
+     */
+    class metrics_timer_t {
+    private:
+      operation_counters_t &                      m_counters;
+      const std::chrono::steady_clock::time_point m_start;
+
+    public:
+      explicit metrics_timer_t( operation_counters_t & counters )
+          : m_counters( counters ), m_start( std::chrono::steady_clock::now( ) ) { }
+
+      ~metrics_timer_t( ) { m_counters.call( std::chrono::steady_clock::now( ) - m_start ); }
+
+      metrics_timer_t( const metrics_timer_t & )             = delete;
+      metrics_timer_t & operator=( const metrics_timer_t & ) = delete;
+    };
+
+    /**
+     * Get counters of process id lookups, shared by the whole program since
+     * lookups happen before process_t exists.
+     * @return counters.
+     */
+    inline operation_counters_t & pid_lookup_counters( ) {
+      static operation_counters_t counters;
+      return counters;
     }
+  } // namespace _internal
+
+  /**
+   * Get metrics of process id lookups of the whole program.
+   * Counters stay zero without TRICKSTER_METRICS.
+   * @return pid_lookup metrics.
+   */
+  [[nodiscard]] inline operation_metrics_t get_pid_lookup_metrics( ) {
+    return _internal::pid_lookup_counters( ).snapshot( );
+  }
+
+  namespace _internal {
 
     /**
-     * Write process memory.
-     * @param address starting address
-     * @param data data to be written
-     * @param size read size (default: sizeof(T))
-     * @return write_result_t struct. See tr.hpp (line 137)
-     *
-     * NOTE: process_vm_writev return value may be less than the total number
-     * of requested bytes, if a partial write occurred. Define TRICKSTER_DEBUG
-     * to see if this situation (the one described above) happens.
+     * Memory read result.
      */
-    template <typename T>
-    std::optional<_internal::write_result_t<T>>
-    write_memory( std::uintptr_t address, const T & data, std::size_t size = sizeof( T ) ) const {
-      tr_assert( is_valid( ), tr_string( "Process is invalid." ) );
+    template <typename T> struct read_result_t {
+      T           data;
+      std::size_t bytes_requested, bytes_read;
+      bool        partial_read = bytes_requested != bytes_read;
+    };
+
+    /**
+     * Memory write result.
+     */
+    template <typename T> struct write_result_t {
+      std::size_t bytes_requested, bytes_written;
+      bool        partial_write = bytes_requested != bytes_written;
+    };
+
+    /**
+     * Check if string contains only digits.
+     * @param string string to check
+     * @return true if only digits, false otherwise
+     */
+    [[nodiscard]] inline bool only_digits( std::string_view string ) {
+      return std::all_of( string.begin( ), string.end( ), ::isdigit );
+    }
+
+    /**
+     * Read up to capacity bytes of small file (e.g. /proc/$PID/comm) with single read(2).
+     * @param path path of the file.
+     * @param buffer destination buffer.
+     * @param capacity size of the buffer.
+     * @return number of bytes read or -1 if file cannot be read.
+     */
+    [[nodiscard]] inline ssize_t read_small_file( const char * path, char * buffer, std::size_t capacity ) {
+      const int fd = open( path, O_RDONLY | O_CLOEXEC );
+      if ( fd == -1 )
+        return -1;
+
+      ssize_t result;
+      do
+        result = read( fd, buffer, capacity );
+      while ( result == -1 && errno == EINTR );
+
+      close( fd );
+      return result;
+    }
+
+    /**
+     * Get filename part of the path.
+     * @param path path.
+     * @return everything after the last '/'.
+     */
+    [[nodiscard]] inline std::string_view filename_of( std::string_view path ) {
+      const auto separator = path.find_last_of( '/' );
+      return separator == std::string_view::npos ? path : path.substr( separator + 1 );
+    }
+
+    /**
+     * Invoke callback for every process id in /proc.
+     * Directory is read with getdents64 into a stack buffer, names are
+     * converted without allocating.
+     * @param callback invoked with each process id, returning false stops the iteration.
+     */
+    template <typename F> void for_each_pid( F && callback ) {
+      struct linux_dirent64_t {
+        std::uint64_t  d_ino;
+        std::int64_t   d_off;
+        unsigned short d_reclen;
+        unsigned char  d_type;
+        // Names are NUL terminated within d_reclen, entries are stepped by it, not by sizeof.
+        char d_name[ 256 ];
+      };
+
+      const int fd = open( tr_string( "/proc" ), O_RDONLY | O_DIRECTORY | O_CLOEXEC );
+      if ( fd == -1 )
+        return;
+
+      alignas( linux_dirent64_t ) char buffer[ 32768 ];
+      for ( ;; ) {
+        const auto length = syscall( SYS_getdents64, fd, buffer, sizeof( buffer ) );
+        if ( length <= 0 )
+          break;
+
+        for ( long position = 0; position < length; ) {
+          const auto entry = reinterpret_cast<const linux_dirent64_t *>( buffer + position );
+          position += entry->d_reclen;
+
+          if ( entry->d_type != DT_DIR || entry->d_name[ 0 ] < '1' || entry->d_name[ 0 ] > '9' )
+            continue;
+
+          int  pid;
+          auto name_end = entry->d_name + std::strlen( entry->d_name );
+          const auto [ next, error ] = std::from_chars( entry->d_name, name_end, pid );
+          if ( error != std::errc { } || next != name_end )
+            continue;
+
+          if ( !callback( pid ) ) {
+            close( fd );
+            return;
+          }
+        }
+      }
+      close( fd );
+    }
+
+    /**
+     * Check if process matches the name.
+     * @param pid process id.
+     * @param process_name name of the process.
+     * @param match property of the process compared with the name.
+     * @return true if process matches, false otherwise or if it does not exist anymore.
+     */
+    [[nodiscard]] inline bool
+    process_matches( const int pid, std::string_view process_name, process_match_t match ) {
+      char path[ 32 ];
+      char buffer[ 4096 ];
+
+      switch ( match ) {
+        case process_match_t::comm: {
+          snprintf( path, sizeof( path ), tr_string( "/proc/%i/comm" ), pid );
+          const auto length = read_small_file( path, buffer, sizeof( buffer ) );
+          if ( length <= 0 )
+            return false;
+          std::string_view comm { buffer, static_cast<std::size_t>( length ) };
+          if ( comm.back( ) == '\n' )
+            comm.remove_suffix( 1 );
+          return comm == process_name;
+        }
+        case process_match_t::cmdline: {
+          snprintf( path, sizeof( path ), tr_string( "/proc/%i/cmdline" ), pid );
+          const auto length = read_small_file( path, buffer, sizeof( buffer ) );
+          if ( length <= 0 )
+            return false;
+          const std::string_view cmdline { buffer, static_cast<std::size_t>( length ) };
+          return filename_of( cmdline.substr( 0, cmdline.find( '\0' ) ) ) == process_name;
+        }
+        case process_match_t::exe: {
+          snprintf( path, sizeof( path ), tr_string( "/proc/%i/exe" ), pid );
+          const auto length = readlink( path, buffer, sizeof( buffer ) );
+          if ( length <= 0 )
+            return false;
+          const std::string_view exe { buffer, static_cast<std::size_t>( length ) };
+          return filename_of( exe ) == process_name;
+        }
+      }
+      return false;
+    }
+
+    /**
+     * Get name (comm) of process.
+     * @param pid process id.
+     * @return name or std::nullopt if process does not exist.
+     */
+    [[nodiscard]] inline std::optional<std::string> get_process_name( const int pid ) {
+      char path[ 32 ];
+      char buffer[ 64 ];
+      snprintf( path, sizeof( path ), tr_string( "/proc/%i/comm" ), pid );
+      const auto length = read_small_file( path, buffer, sizeof( buffer ) );
+      if ( length <= 0 )
+        return std::nullopt;
+
+      std::string name { buffer, static_cast<std::size_t>( length ) };
+      if ( name.back( ) == '\n' )
+        name.pop_back( );
+      return name;
+    }
 
-      iovec local[ 1 ], remote[ 1 ];
+    /**
+     * Get process id by name.
+     * @param process_name name of the process.
+     * @param match property of the process compared with the name (default: comm).
+     * @return id of the process or std::nullopt if function fails.
+     */
+    [[nodiscard]] inline std::optional<int>
+    get_pid_by_name( std::string_view process_name, process_match_t match = process_match_t::comm ) {
+      tr_assert( !process_name.empty( ), "Process name is 0 length." );
+#ifdef TRICKSTER_METRICS
+      const metrics_timer_t timer( pid_lookup_counters( ) );
+#endif
 
-      local[ 0 ].iov_base  = const_cast<T *>( std::addressof( data ) );
-      local[ 0 ].iov_len   = size;
-      remote[ 0 ].iov_base = (void *)( address );
-      remote[ 0 ].iov_len  = size;
+      std::optional<int> result;
+      for_each_pid( [ & ]( int pid ) {
+        if ( !process_matches( pid, process_name, match ) )
+          return true;
+        result = pid;
+        return false;
+      } );
 
-      const std::size_t result = process_vm_writev( m_id, local, 1, remote, 1, 0 );
+#ifdef TRICKSTER_METRICS
+      if ( !result.has_value( ) )
+        pid_lookup_counters( ).failure( ESRCH );
+#endif
 
-      if ( result == -1 ) {
 #ifdef TRICKSTER_DEBUG
+      if ( !result.has_value( ) ) {
         _internal::log<_internal::log_levels_t::error>(
-            tr_string( "Memory writing (at %p) failed with error code: %i, Message: %s" ),
-            address,
-            errno,
-            strerror( errno ) );
+            tr_string( "Could not get '%.*s' process id. Consider checking if it exists." ),
+            static_cast<int>( process_name.size( ) ),
+            process_name.data( ) );
+      }
+#endif
+      return result;
+    }
+
+    /**
+     * Get ids of all processes with given name in single /proc pass.
+     * @param process_name name of the processes.
+     * @param match property of the process compared with the name (default: comm).
+     * @return ids of matching processes in /proc order.
+     */
+    [[nodiscard]] inline std::vector<int> get_pids_by_name( std::string_view process_name,
+                                                            process_match_t  match = process_match_t::comm ) {
+      tr_assert( !process_name.empty( ), "Process name is 0 length." );
+#ifdef TRICKSTER_METRICS
+      const metrics_timer_t timer( pid_lookup_counters( ) );
 #endif
+
+      std::vector<int> pids;
+      for_each_pid( [ & ]( int pid ) {
+        if ( process_matches( pid, process_name, match ) )
+          pids.push_back( pid );
+        return true;
+      } );
+      return pids;
+    }
+
+    /**
+     * Read whole file into the buffer using read(2).
+     * Files under /proc report 0 size, so the buffer is grown until EOF.
+     * Existing capacity of the buffer is reused between calls.
+     * @param path path of the file.
+     * @param buffer destination buffer, its previous contents are discarded.
+     * @return true if file was read, false otherwise.
+     */
+    [[nodiscard]] inline bool read_file( const char * path, std::string & buffer ) {
+      const int fd = open( path, O_RDONLY | O_CLOEXEC );
+      if ( fd == -1 )
+        return false;
+
+      if ( buffer.capacity( ) < 4096 )
+        buffer.reserve( 4096 );
+      buffer.resize( buffer.capacity( ) );
+
+      std::size_t length = 0;
+      for ( ;; ) {
+        if ( length == buffer.size( ) )
+          buffer.resize( buffer.size( ) * 2 );
+
+        const ssize_t result = read( fd, buffer.data( ) + length, buffer.size( ) - length );
+        if ( result == -1 ) {
+          if ( errno == EINTR )
+            continue;
+          close( fd );
+          buffer.clear( );
+          return false;
+        }
+        if ( result == 0 )
+          break;
+        length += static_cast<std::size_t>( result );
+      }
+
+      close( fd );
+      buffer.resize( length );
+      return true;
+    }
+
+    /**
+     * Single /proc/$PID/maps row decoded in place.
+     * pathname points into the parsed buffer and is valid as long as the buffer is.
+     */
+    struct maps_entry_t {
+      std::uint64_t    start, end;
+      bool             readable, writable, executable, shared;
+      std::uint64_t    offset;
+      std::uint64_t    device_major, device_minor;
+      std::uint64_t    inode;
+      std::string_view pathname;
+    };
+
+    /**
+     * Parse number at the cursor and advance the cursor past it.
+     * @param cursor current position, updated on success.
+     * @param end end of the line.
+     * @param value parsed number.
+     * @param base numeric base of the field.
+     * @return true if number was parsed, false otherwise.
+     */
+    [[nodiscard]] inline bool
+    parse_maps_field( const char *& cursor, const char * end, std::uint64_t & value, int base = 16 ) {
+      const auto [ next, error ] = std::from_chars( cursor, end, value, base );
+      if ( error != std::errc { } )
+        return false;
+      cursor = next;
+      return true;
+    }
+
+    /**
+     * Decode single /proc/$PID/maps row without allocating.
+     * @param line row without the trailing newline.
+     * @return decoded row or std::nullopt if row is malformed.
+     */
+    [[nodiscard]] inline std::optional<maps_entry_t> parse_maps_entry( std::string_view line ) {
+      maps_entry_t entry;
+      const char * cursor = line.data( );
+      const char * end    = line.data( ) + line.size( );
+
+      if ( !parse_maps_field( cursor, end, entry.start ) || cursor == end || *cursor++ != '-' )
+        return std::nullopt;
+      if ( !parse_maps_field( cursor, end, entry.end ) || end - cursor < 6 || *cursor++ != ' ' )
+        return std::nullopt;
+
+      entry.readable   = cursor[ 0 ] == 'r';
+      entry.writable   = cursor[ 1 ] == 'w';
+      entry.executable = cursor[ 2 ] == 'x';
+      entry.shared     = cursor[ 3 ] != 'p';
+      cursor += 5;
+
+      if ( !parse_maps_field( cursor, end, entry.offset ) || cursor == end || *cursor++ != ' ' )
+        return std::nullopt;
+      if ( !parse_maps_field( cursor, end, entry.device_major ) || cursor == end || *cursor++ != ':' )
         return std::nullopt;
+      if ( !parse_maps_field( cursor, end, entry.device_minor ) || cursor == end || *cursor++ != ' ' )
+        return std::nullopt;
+      if ( !parse_maps_field( cursor, end, entry.inode, 10 ) )
+        return std::nullopt;
+
+      while ( cursor != end && *cursor == ' ' )
+        cursor++;
+
+      entry.pathname = std::string_view { cursor, static_cast<std::size_t>( end - cursor ) };
+      return entry;
+    }
+
+    /**
+     * Decode every row of /proc/$PID/maps contents in single pass.
+     * Malformed rows are skipped.
+     * @param buffer contents of the maps file.
+     * @param callback invoked with each decoded maps_entry_t.
+     */
+    template <typename F> void for_each_maps_entry( std::string_view buffer, F && callback ) {
+      const char * cursor = buffer.data( );
+      const char * end    = buffer.data( ) + buffer.size( );
+
+      while ( cursor < end ) {
+        const char * line_end = static_cast<const char *>( std::memchr( cursor, '\n', end - cursor ) );
+        if ( line_end == nullptr )
+          line_end = end;
+
+        if ( const auto entry = parse_maps_entry(
+                 std::string_view { cursor, static_cast<std::size_t>( line_end - cursor ) } ) )
+          callback( *entry );
+
+        cursor = line_end + 1;
       }
-#ifdef TRICKSTER_DEBUG
-      if ( result != size ) {
-        _internal::log<_internal::log_levels_t::info>( tr_string( "Partial write occured." ) );
+    }
+
+    /**
+     * Convert decoded maps row into memory region.
+     * This is the only place where region's path is allocated.
+     * @param entry decoded maps row.
+     * @return memory region.
+     */
+    [[nodiscard]] inline memory_region_t to_memory_region( const maps_entry_t & entry ) {
+      memory_region_t region;
+      region.start        = entry.start;
+      region.end          = entry.end;
+      region.readable     = entry.readable;
+      region.writable     = entry.writable;
+      region.executable   = entry.executable;
+      region.shared       = entry.shared;
+      region.offset       = entry.offset;
+      region.device_major = entry.device_major;
+      region.device_minor = entry.device_minor;
+      region.inode        = entry.inode;
+      region.special      = !entry.pathname.empty( ) && entry.pathname.front( ) == '[';
+
+      if ( !entry.pathname.empty( ) ) {
+        region.path = std::filesystem::path { entry.pathname };
+
+        const auto separator = entry.pathname.find_last_of( '/' );
+        region.filename      = std::string { separator == std::string_view::npos
+                                                 ? entry.pathname
+                                                 : entry.pathname.substr( separator + 1 ) };
       }
-#endif
-      return _internal::write_result_t<T> { size, result };
+      return region;
     }
 
-    [[nodiscard]] std::optional<std::uintptr_t> get_call_address( std::uintptr_t address ) const {
-      tr_assert( is_valid( ), tr_string( "Process is invalid." ) );
+    /**
+     * Check if decoded maps row describes the same region as previously parsed one.
+     * @param region previously parsed region.
+     * @param entry decoded maps row.
+     * @return true if all fields are equal, false otherwise.
+     */
+    [[nodiscard]] inline bool same_region( const memory_region_t & region, const maps_entry_t & entry ) {
+      return region.start == entry.start && region.end == entry.end && region.offset == entry.offset &&
+             region.inode == entry.inode && region.readable == entry.readable &&
+             region.writable == entry.writable && region.executable == entry.executable &&
+             region.shared == entry.shared && region.device_major == entry.device_major &&
+             region.device_minor == entry.device_minor && region.path.native( ) == entry.pathname;
+    }
 
-      const auto memory_opt = read_memory<std::uintptr_t>( address + 0x1, sizeof( std::uint32_t ) );
-      if ( memory_opt.has_value( ) && !memory_opt.value( ).partial_read ) {
-        return ( memory_opt.value( ).data + ( address + 0x5 ) );
-      } else {
+    /**
+     * Parse contents of /proc/$PID/maps reusing regions parsed previously.
+     * Both maps are sorted by start address, so they are merged in single pass.
+     * Unchanged regions are moved from the previous map, changed regions reuse
+     * previous path allocation if the path did not change.
+     * @param buffer contents of the maps file.
+     * @param previous regions parsed previously, left in moved-from state.
+     * @param regions receives regions parsed now, previous contents are discarded.
+     * @return difference between previous and current regions.
+     */
+    inline memory_region_diff_t refresh_memory_regions( std::string_view               buffer,
+                                                        std::vector<memory_region_t> & previous,
+                                                        std::vector<memory_region_t> & regions ) {
+      memory_region_diff_t diff;
+      std::size_t          cursor = 0;
+
+      regions.clear( );
+      for_each_maps_entry( buffer, [ & ]( const maps_entry_t & entry ) {
+        for ( ; cursor < previous.size( ) && previous[ cursor ].start < entry.start; cursor++ )
+          diff.removed.push_back( std::move( previous[ cursor ] ) );
+
+        if ( cursor == previous.size( ) || previous[ cursor ].start != entry.start ) {
+          diff.added.push_back( regions.size( ) );
+          regions.push_back( to_memory_region( entry ) );
+          return;
+        }
+
+        auto & old = previous[ cursor++ ];
+        if ( same_region( old, entry ) ) {
+          regions.push_back( std::move( old ) );
+          return;
+        }
+
+        diff.changed.push_back( regions.size( ) );
+        if ( old.path.native( ) != entry.pathname ) {
+          regions.push_back( to_memory_region( entry ) );
+          return;
+        }
+
+        // Only the numeric fields changed, keep the path and filename allocations.
+        memory_region_t region { std::move( old ) };
+        region.start        = entry.start;
+        region.end          = entry.end;
+        region.readable     = entry.readable;
+        region.writable     = entry.writable;
+        region.executable   = entry.executable;
+        region.shared       = entry.shared;
+        region.offset       = entry.offset;
+        region.device_major = entry.device_major;
+        region.device_minor = entry.device_minor;
+        region.inode        = entry.inode;
+        regions.push_back( std::move( region ) );
+      } );
+
+      for ( ; cursor < previous.size( ); cursor++ )
+        diff.removed.push_back( std::move( previous[ cursor ] ) );
+      return diff;
+    }
+
+    /**
+     * Parse contents of /proc/$PID/maps into memory regions.
+     * @param buffer contents of the maps file.
+     * @return std::vector containing memory regions as its entries.
+     */
+    [[nodiscard]] inline std::vector<memory_region_t> parse_memory_regions( std::string_view buffer ) {
+      std::vector<memory_region_t> regions;
+      regions.reserve( std::count( buffer.begin( ), buffer.end( ), '\n' ) + 1 );
+
+      for_each_maps_entry( buffer, [ & ]( const maps_entry_t & entry ) {
+        regions.push_back( to_memory_region( entry ) );
+      } );
+      return regions;
+    }
+
+    /**
+     * Get process memory regions.
+     * @param pid process id.
+     * @param buffer scratch buffer for maps file contents, reusing it between
+     * calls avoids reallocation.
+     * @return std::vector containing memory regions as its entries, it is good
+     * to check if returned vector is not empty because it means that process
+     * with id provided in function call does not exist.
+     */
+    [[nodiscard]] inline std::vector<memory_region_t> map_memory_regions( const int     pid,
+                                                                          std::string & buffer ) {
+      char path[ 32 ];
+      snprintf( path, sizeof( path ), tr_string( "/proc/%i/maps" ), pid );
+
+      if ( !_internal::read_file( path, buffer ) ) {
 #ifdef TRICKSTER_DEBUG
         _internal::log<_internal::log_levels_t::error>(
-            tr_string( "Failed to get call address of %d. If this message is exactly after read memory "
-                       "error, refer to it." ),
-            address );
+            tr_string( "Could not get memory regions of process with %i id. Consider checking if it exists." ),
+            pid );
 #endif
-        return std::nullopt;
+        return {};
+      }
+      return _internal::parse_memory_regions( buffer );
+    }
+
+    /**
+     * Get process memory regions.
+     * @param pid process id.
+     * @return std::vector containing memory regions as its entries, it is good
+     * to check if returned vector is not empty because it means that process
+     * with id provided in function call does not exist.
+     */
+    [[nodiscard]] inline std::vector<memory_region_t> map_memory_regions( const int pid ) {
+      std::string buffer;
+      return _internal::map_memory_regions( pid, buffer );
+    }
+
+#ifdef IOV_MAX
+    constexpr std::size_t iov_max = IOV_MAX;
+#else
+    constexpr std::size_t iov_max = 1024;
+#endif
+
+    /**
+     * Vectored transfer between local and remote process memory.
+     * Entries are packed up to iov_max per process_vm_readv / process_vm_writev
+     * call. Kernel stops at the first faulting remote entry, so when transfer
+     * stops short, the entry it stopped at is recorded as partial (or failed)
+     * and the batch is resumed from the next entry.
+     * @param pid process id.
+     * @param count number of entries.
+     * @param entry_at callable filling local and remote iovec of entry with given index.
+     * @param transferred per entry transferred bytes (can be nullptr).
+     * @param counters receives system call counters with TRICKSTER_METRICS (can be nullptr).
+     * @return number of fully transferred entries or std::nullopt if process
+     * memory cannot be accessed at all.
+     */
+    template <bool Write, typename F>
+    [[nodiscard]] std::optional<std::size_t>
+    vm_transfer( const int                               pid,
+                 const std::size_t                       count,
+                 F &&                                    entry_at,
+                 std::size_t *                           transferred,
+                 [[maybe_unused]] operation_counters_t * counters = nullptr ) {
+      iovec       local[ iov_max ], remote[ iov_max ];
+      std::size_t completed = 0, index = 0;
+
+      while ( index < count ) {
+        const std::size_t batch = std::min( count - index, iov_max );
+        for ( std::size_t i = 0; i < batch; i++ )
+          entry_at( index + i, local[ i ], remote[ i ] );
+
+        ssize_t result;
+        if constexpr ( Write )
+          result = process_vm_writev( pid, local, batch, remote, batch, 0 );
+        else
+          result = process_vm_readv( pid, local, batch, remote, batch, 0 );
+
+#ifdef TRICKSTER_METRICS
+        if ( counters ) {
+          std::size_t requested = 0;
+          for ( std::size_t i = 0; i < batch; i++ )
+            requested += remote[ i ].iov_len;
+          counters->syscall( requested, result, errno );
+        }
+#endif
+
+        if ( result == -1 ) {
+          // First remote entry of the batch is not accessible, skip it.
+          if ( errno == EFAULT ) {
+            if ( transferred )
+              transferred[ index ] = 0;
+            index++;
+            continue;
+          }
+#ifdef TRICKSTER_DEBUG
+          _internal::log<_internal::log_levels_t::error>(
+              tr_string( "Batched memory transfer failed with error code: %i, Message: %s" ),
+              errno,
+              strerror( errno ) );
+#endif
+          if ( transferred )
+            std::fill( transferred + index, transferred + count, 0 );
+          return std::nullopt;
+        }
+
+        auto        remaining = static_cast<std::size_t>( result );
+        std::size_t i         = 0;
+        for ( ; i < batch && remaining >= remote[ i ].iov_len; i++ ) {
+          if ( transferred )
+            transferred[ index + i ] = remote[ i ].iov_len;
+          remaining -= remote[ i ].iov_len;
+          completed++;
+        }
+
+        if ( i < batch ) {
+          if ( transferred )
+            transferred[ index + i ] = remaining;
+          i++;
+        }
+        index += i;
       }
+
+      return completed;
+    }
+
+    /**
+     * Vectored transfer through /proc/$PID/mem file descriptor.
+     * Runs of entries contiguous in remote memory are transferred with single
+     * preadv / pwritev call. See vm_transfer for the semantics.
+     * @param fd open /proc/$PID/mem file descriptor.
+     */
+    template <bool Write, typename F>
+    [[nodiscard]] std::optional<std::size_t>
+    proc_mem_transfer( const int                               fd,
+                       const std::size_t                       count,
+                       F &&                                    entry_at,
+                       std::size_t *                           transferred,
+                       [[maybe_unused]] operation_counters_t * counters = nullptr ) {
+      iovec       local[ iov_max ], remote[ iov_max ];
+      std::size_t completed = 0, index = 0;
+
+      while ( index < count ) {
+        std::size_t batch = 1;
+        entry_at( index, local[ 0 ], remote[ 0 ] );
+        for ( ; index + batch < count && batch < iov_max; batch++ ) {
+          entry_at( index + batch, local[ batch ], remote[ batch ] );
+          const auto previous_end =
+              static_cast<std::uint8_t *>( remote[ batch - 1 ].iov_base ) + remote[ batch - 1 ].iov_len;
+          if ( remote[ batch ].iov_base != previous_end )
+            break;
+        }
+
+        const auto offset = static_cast<off_t>( reinterpret_cast<std::uintptr_t>( remote[ 0 ].iov_base ) );
+        ssize_t    result;
+        do {
+          if constexpr ( Write )
+            result = pwritev( fd, local, static_cast<int>( batch ), offset );
+          else
+            result = preadv( fd, local, static_cast<int>( batch ), offset );
+#ifdef TRICKSTER_METRICS
+          if ( counters ) {
+            std::size_t requested = 0;
+            for ( std::size_t i = 0; i < batch; i++ )
+              requested += local[ i ].iov_len;
+            counters->syscall( requested, result, errno );
+          }
+#endif
+        } while ( result == -1 && errno == EINTR );
+
+        if ( result == -1 ) {
+          if ( errno == EIO || errno == EFAULT ) {
+            if ( transferred )
+              transferred[ index ] = 0;
+            index++;
+            continue;
+          }
+#ifdef TRICKSTER_DEBUG
+          _internal::log<_internal::log_levels_t::error>(
+              tr_string( "/proc/$PID/mem transfer failed with error code: %i, Message: %s" ),
+              errno,
+              strerror( errno ) );
+#endif
+          if ( transferred )
+            std::fill( transferred + index, transferred + count, 0 );
+          return std::nullopt;
+        }
+
+        auto        remaining = static_cast<std::size_t>( result );
+        std::size_t i         = 0;
+        for ( ; i < batch && remaining >= local[ i ].iov_len; i++ ) {
+          if ( transferred )
+            transferred[ index + i ] = local[ i ].iov_len;
+          remaining -= local[ i ].iov_len;
+          completed++;
+        }
+
+        if ( i < batch ) {
+          if ( transferred )
+            transferred[ index + i ] = remaining;
+          i++;
+        }
+        index += i;
+      }
+
+      return completed;
+    }
+
+    /**
+     * Transfer using PTRACE_PEEKDATA / PTRACE_POKEDATA word by word.
+     * Process is attached and stopped for the duration of the call. Process
+     * can have only one tracer, so calls for the same pid must not overlap,
+     * process_t serializes them.
+     * See vm_transfer for the semantics.
+     * @param pid process id.
+     */
+    template <bool Write, typename F>
+    [[nodiscard]] std::optional<std::size_t>
+    ptrace_transfer( const int                               pid,
+                     const std::size_t                       count,
+                     F &&                                    entry_at,
+                     std::size_t *                           transferred,
+                     [[maybe_unused]] operation_counters_t * counters = nullptr ) {
+#ifdef TRICKSTER_METRICS
+      const auto record = [ counters ]( std::size_t requested, bool failed ) {
+        if ( counters )
+          counters->syscall( requested, failed ? -1 : static_cast<ssize_t>( requested ), errno );
+      };
+#endif
+
+      if ( ptrace( PTRACE_ATTACH, pid, nullptr, nullptr ) == -1 ) {
+#ifdef TRICKSTER_METRICS
+        if ( counters )
+          counters->failure( errno );
+#endif
+#ifdef TRICKSTER_DEBUG
+        _internal::log<_internal::log_levels_t::error>(
+            tr_string( "Attaching to process %i failed with error code: %i, Message: %s" ),
+            pid,
+            errno,
+            strerror( errno ) );
+#endif
+        if ( transferred )
+          std::fill( transferred, transferred + count, 0 );
+        return std::nullopt;
+      }
+
+      int  status = 0;
+      auto waited = waitpid( pid, &status, __WALL );
+      while ( waited == -1 && errno == EINTR )
+        waited = waitpid( pid, &status, __WALL );
+
+      // Memory of a process that exited instead of stopping can not be peeked.
+      if ( waited == -1 || !WIFSTOPPED( status ) ) {
+#ifdef TRICKSTER_METRICS
+        if ( counters )
+          counters->failure( waited == -1 ? errno : ESRCH );
+#endif
+#ifdef TRICKSTER_DEBUG
+        _internal::log<_internal::log_levels_t::error>(
+            tr_string( "Process %i did not stop after attaching, status: %i" ), pid, status );
+#endif
+        if ( waited == -1 )
+          ptrace( PTRACE_DETACH, pid, nullptr, nullptr );
+        if ( transferred )
+          std::fill( transferred, transferred + count, 0 );
+        return std::nullopt;
+      }
+
+      // Signal that stopped the process before our SIGSTOP is delivered again on detach.
+      const auto pending = WSTOPSIG( status ) == SIGSTOP ? 0 : WSTOPSIG( status );
+
+      constexpr std::size_t word_size = sizeof( long );
+      std::size_t           completed = 0;
+
+      for ( std::size_t index = 0; index < count; index++ ) {
+        iovec local, remote;
+        entry_at( index, local, remote );
+
+        const auto  address = reinterpret_cast<std::uintptr_t>( remote.iov_base );
+        const auto  data    = static_cast<std::uint8_t *>( local.iov_base );
+        std::size_t done    = 0;
+
+        while ( done < remote.iov_len ) {
+          const auto cursor  = address + done;
+          const auto aligned = cursor & ~( word_size - 1 );
+          const auto skip    = cursor - aligned;
+          const auto length  = std::min( word_size - skip, remote.iov_len - done );
+
+          errno           = 0;
+          const long word = ptrace( PTRACE_PEEKDATA, pid, reinterpret_cast<void *>( aligned ), nullptr );
+#ifdef TRICKSTER_METRICS
+          record( length, errno != 0 );
+#endif
+          if ( errno != 0 )
+            break;
+
+          if constexpr ( Write ) {
+            long patched = word;
+            std::memcpy( reinterpret_cast<std::uint8_t *>( &patched ) + skip, data + done, length );
+            const auto poked = ptrace( PTRACE_POKEDATA, pid, reinterpret_cast<void *>( aligned ), patched );
+#ifdef TRICKSTER_METRICS
+            record( length, poked == -1 );
+#endif
+            if ( poked == -1 )
+              break;
+          } else {
+            std::memcpy( data + done, reinterpret_cast<const std::uint8_t *>( &word ) + skip, length );
+          }
+          done += length;
+        }
+
+        if ( transferred )
+          transferred[ index ] = done;
+        if ( done == remote.iov_len )
+          completed++;
+      }
+
+      const auto signal = static_cast<std::uintptr_t>( pending );
+      ptrace( PTRACE_DETACH, pid, nullptr, reinterpret_cast<void *>( signal ) );
+      return completed;
+    }
+
+    /**
+     * Open /proc/$PID/mem, for writing if permitted.
+     * @param pid process id.
+     * @return file descriptor or -1 if file cannot be opened.
+     */
+    [[nodiscard]] inline int open_proc_mem( const int pid ) {
+      char path[ 32 ];
+      snprintf( path, sizeof( path ), tr_string( "/proc/%i/mem" ), pid );
+
+      int fd = open( path, O_RDWR | O_CLOEXEC );
+      if ( fd == -1 )
+        fd = open( path, O_RDONLY | O_CLOEXEC );
+#ifdef TRICKSTER_DEBUG
+      if ( fd == -1 ) {
+        _internal::log<_internal::log_levels_t::error>(
+            tr_string( "Opening %s failed with error code: %i, Message: %s" ),
+            path,
+            errno,
+            strerror( errno ) );
+      }
+#endif
+      return fd;
+    }
+
+    /**
+     * Open /proc/$PID/pagemap.
+     * @param pid process id.
+     * @return file descriptor or -1 if file cannot be opened.
+     */
+    [[nodiscard]] inline int open_pagemap( const int pid ) {
+      char path[ 32 ];
+      snprintf( path, sizeof( path ), tr_string( "/proc/%i/pagemap" ), pid );
+      return open( path, O_RDONLY | O_CLOEXEC );
+    }
+
+    constexpr std::uint64_t pagemap_present    = std::uint64_t { 1 } << 63;
+    constexpr std::uint64_t pagemap_swapped    = std::uint64_t { 1 } << 62;
+    constexpr std::uint64_t pagemap_soft_dirty = std::uint64_t { 1 } << 55;
+
+    /**
+     * Check if region is private anonymous memory, whose pages that are neither
+     * present nor swapped were never written and read as zeros.
+     * @param region memory region.
+     * @return state of statement above.
+     */
+    [[nodiscard]] inline bool is_private_anonymous( const memory_region_t & region ) noexcept {
+      return region.inode == 0 && !region.shared;
+    }
+  } // namespace _internal
+
+  /**
+   * tr's utilities namespace.
+   */
+  namespace utils {
+
+    /**
+     * Get ids of all processes with given name.
+     * @param process_name name of the processes.
+     * @param match property of the process compared with the name (default: comm).
+     * @return ids of matching processes.
+     */
+    [[nodiscard]] inline std::vector<int> get_process_ids( std::string_view process_name,
+                                                           process_match_t  match = process_match_t::comm ) {
+      return _internal::get_pids_by_name( process_name, match );
+    }
+
+    // TODO: Error checking
+    /**
+     * Utility function for getting list of shared objects
+     * loaded into process memory without duplicate entries.
+     * @param regions mapped memory regions where modules are located.
+     * @return prettified list of loaded modules, see module_table_t for
+     * base addresses and segments of the modules.
+     */
+    [[nodiscard]] inline std::vector<std::string>
+    get_modules( const std::vector<memory_region_t> & regions ) {
+      std::vector<std::string> modules;
+
+      modules.reserve( regions.size( ) );
+
+      for ( const auto & region : regions )
+        if ( region.filename.find( tr_string( ".so" ) ) != std::string::npos )
+          modules.push_back( region.filename );
+
+      std::sort( modules.begin( ), modules.end( ) );
+      modules.erase( std::unique( modules.begin( ), modules.end( ) ), modules.end( ) );
+
+      modules.shrink_to_fit( );
+
+      return modules;
+    }
+  } // namespace utils
+
+  /**
+   * Fixed size pool of worker threads executing parallel loops.
+   * Thread calling parallel_for participates in the loop, so pool of size 1
+   * has no workers and runs everything on the calling thread. Loops can run
+   * concurrently and nest: idle workers steal iterations of any active loop,
+   * newest first, so a loop started from inside of another loop's job (e.g.
+   * per process scans of process_group_t) is spread across the pool as well.
+   */
+  class thread_pool_t {
+  public:
+    /**
+     * Loop body, receives index of the iteration and index of the thread
+     * executing it (0 is a thread outside of the pool), which can be used to
+     * address per thread scratch buffers of the loop.
+     */
+    using job_t = std::function<void( std::size_t index, std::size_t worker )>;
+
+  private:
+    struct loop_t {
+      const job_t *            job;
+      std::size_t              count;
+      std::atomic<std::size_t> next { 0 }, done { 0 };
+      // Workers that joined the loop, guarded by m_mutex.
+      std::size_t users = 0;
+    };
+
+    std::vector<std::thread> m_workers;
+    std::mutex               m_mutex;
+    std::condition_variable  m_wake, m_finished;
+    std::vector<loop_t *>    m_loops;
+    bool                     m_stopping = false;
+
+    /**
+     * Get pool and worker index of the calling thread.
+     */
+    static std::pair<const thread_pool_t *, std::size_t> & current( ) {
+      thread_local std::pair<const thread_pool_t *, std::size_t> current { nullptr, 0 };
+      return current;
+    }
+
+    loop_t * find_loop( ) const noexcept {
+      for ( auto loop = m_loops.rbegin( ); loop != m_loops.rend( ); loop++ )
+        if ( ( *loop )->next.load( std::memory_order_relaxed ) < ( *loop )->count )
+          return *loop;
+      return nullptr;
+    }
+
+    void run_loop( loop_t & loop, std::size_t worker ) {
+      for ( ;; ) {
+        const auto index = loop.next.fetch_add( 1, std::memory_order_relaxed );
+        if ( index >= loop.count )
+          return;
+
+        ( *loop.job )( index, worker );
+        if ( loop.done.fetch_add( 1, std::memory_order_acq_rel ) + 1 == loop.count ) {
+          // Owner checks done under the mutex, taking it here prevents lost wakeup.
+          {
+            std::lock_guard lock( m_mutex );
+          }
+          m_finished.notify_all( );
+        }
+      }
+    }
+
+    void worker_loop( std::size_t worker ) {
+      current( ) = { this, worker };
+      std::unique_lock lock( m_mutex );
+      for ( ;; ) {
+        loop_t * loop = nullptr;
+        m_wake.wait( lock, [ & ] { return m_stopping || ( loop = find_loop( ) ) != nullptr; } );
+        if ( m_stopping )
+          return;
+
+        loop->users++;
+        lock.unlock( );
+        run_loop( *loop, worker );
+        lock.lock( );
+        if ( --loop->users == 0 )
+          m_finished.notify_all( );
+      }
+    }
+
+  public:
+    /**
+     * Create thread pool.
+     * @param threads number of threads including the calling one (default: hardware concurrency).
+     */
+    explicit thread_pool_t( std::size_t threads = std::thread::hardware_concurrency( ) ) {
+      for ( std::size_t worker = 1; worker < threads; worker++ )
+        m_workers.emplace_back( [ this, worker ] { worker_loop( worker ); } );
+    }
+
+    ~thread_pool_t( ) {
+      {
+        std::lock_guard lock( m_mutex );
+        m_stopping = true;
+      }
+      m_wake.notify_all( );
+      for ( auto & worker : m_workers )
+        worker.join( );
+    }
+
+    thread_pool_t( const thread_pool_t & )             = delete;
+    thread_pool_t & operator=( const thread_pool_t & ) = delete;
+
+    /**
+     * Get pool shared by all tr's parallel algorithms by default.
+     * @return shared thread pool.
+     */
+    [[nodiscard]] static thread_pool_t & shared( ) {
+      static thread_pool_t pool;
+      return pool;
+    }
+
+    /**
+     * Get number of threads executing parallel loops.
+     * @return number of workers plus the calling thread.
+     */
+    [[nodiscard]] std::size_t size( ) const noexcept { return m_workers.size( ) + 1; }
+
+    /**
+     * Run job for every index in [0, count) and wait for completion.
+     * Indices are handed out in increasing order. Can be called from many
+     * threads at once and from inside of a job, the calling thread executes
+     * iterations of its own loop only.
+     * @param count number of iterations.
+     * @param job loop body.
+     */
+    void parallel_for( std::size_t count, const job_t & job ) {
+      if ( count == 0 )
+        return;
+
+      const auto [ pool, id ] = current( );
+      const auto worker       = pool == this ? id : 0;
+      if ( m_workers.empty( ) || count == 1 ) {
+        for ( std::size_t index = 0; index < count; index++ )
+          job( index, worker );
+        return;
+      }
+
+      loop_t loop;
+      loop.job   = &job;
+      loop.count = count;
+      {
+        std::lock_guard lock( m_mutex );
+        m_loops.push_back( &loop );
+      }
+      m_wake.notify_all( );
+
+      run_loop( loop, worker );
+
+      std::unique_lock lock( m_mutex );
+      m_finished.wait( lock, [ & ] {
+        return loop.done.load( std::memory_order_acquire ) == count && loop.users == 0;
+      } );
+      m_loops.erase( std::find( m_loops.begin( ), m_loops.end( ), &loop ) );
+    }
+  };
+
+  /**
+   * Byte signature with wildcards, e.g. "48 8B ?? ?? E8".
+   */
+  struct pattern_t {
+    /**
+     * Bytes of the signature, wildcard positions hold 0.
+     */
+    std::vector<std::uint8_t> bytes;
+
+    /**
+     * 0xFF for bytes that have to match, 0x00 for wildcards.
+     */
+    std::vector<std::uint8_t> mask;
+
+    /**
+     * Parse IDA style signature.
+     * Bytes are hexadecimal pairs separated by whitespace, wildcards are ? or ??.
+     * @param signature signature to parse.
+     * @return parsed pattern or std::nullopt if signature is malformed or
+     * contains only wildcards.
+     */
+    [[nodiscard]] static std::optional<pattern_t> parse( std::string_view signature ) {
+      pattern_t pattern;
+      bool      concrete = false;
+
+      std::size_t cursor = 0;
+      while ( cursor < signature.size( ) ) {
+        if ( std::isspace( static_cast<unsigned char>( signature[ cursor ] ) ) ) {
+          cursor++;
+          continue;
+        }
+
+        auto token_end = cursor;
+        while ( token_end < signature.size( ) &&
+                !std::isspace( static_cast<unsigned char>( signature[ token_end ] ) ) )
+          token_end++;
+        const auto token = signature.substr( cursor, token_end - cursor );
+        cursor           = token_end;
+
+        if ( token == tr_string( "?" ) || token == tr_string( "??" ) ) {
+          pattern.bytes.push_back( 0 );
+          pattern.mask.push_back( 0x00 );
+          continue;
+        }
+
+        std::uint8_t byte;
+        const auto   token_end_ptr = token.data( ) + token.size( );
+        const auto [ next, error ] = std::from_chars( token.data( ), token_end_ptr, byte, 16 );
+        if ( token.size( ) != 2 || error != std::errc { } || next != token_end_ptr )
+          return std::nullopt;
+
+        pattern.bytes.push_back( byte );
+        pattern.mask.push_back( 0xFF );
+        concrete = true;
+      }
+
+      if ( !concrete )
+        return std::nullopt;
+      return pattern;
+    }
+
+    /**
+     * Get length of the signature.
+     * @return number of bytes including wildcards.
+     */
+    [[nodiscard]] std::size_t size( ) const noexcept { return bytes.size( ); }
+  };
+
+  /**
+   * Memory scan options.
+   */
+  struct scan_options_t {
+    /**
+     * Scan only executable regions.
+     */
+    bool executable_only = false;
+
+    /**
+     * Scan only regions of module with this filename (e.g. libc.so.6), empty scans all regions.
+     */
+    std::string_view module;
+
+    /**
+     * Maximum number of results, 0 means no limit. Results are always the
+     * lowest matching addresses, so limit of 1 returns the first match.
+     */
+    std::size_t limit = 0;
+
+    /**
+     * Size of memory read at once by single thread.
+     */
+    std::size_t chunk_size = 1 << 20;
+
+    /**
+     * Thread pool scan is split across (default: thread_pool_t::shared()).
+     */
+    thread_pool_t * pool = nullptr;
+  };
+
+  namespace _internal {
+    /**
+     * Approximate rank of byte frequency in x86-64 code and data, 0 for the
+     * uncommon bytes. Used to anchor pattern search on its rarest bytes.
+     * @param byte byte to rank.
+     * @return frequency rank, higher is more common.
+     */
+    [[nodiscard]] constexpr int byte_frequency( std::uint8_t byte ) {
+      constexpr std::uint8_t common[] = { 0x00, 0xFF, 0x48, 0x8B, 0x89, 0x24, 0x0F, 0xE8, 0x4C, 0x44, 0x85,
+                                          0x83, 0x01, 0x74, 0x75, 0x8D, 0xC0, 0x45, 0x41, 0xC3, 0xCC, 0x90,
+                                          0x10, 0x08, 0x20, 0x40, 0x02, 0x04, 0x49, 0x31, 0xE9, 0x84 };
+      for ( std::size_t i = 0; i < sizeof( common ); i++ )
+        if ( common[ i ] == byte )
+          return static_cast<int>( sizeof( common ) - i );
+      return 0;
+    }
+
+    /**
+     * Positions of two rarest concrete bytes of the pattern.
+     * If pattern has single concrete byte both positions are the same.
+     */
+    struct pattern_anchors_t {
+      std::size_t first, second;
+    };
+
+    [[nodiscard]] inline pattern_anchors_t select_anchors( const pattern_t & pattern ) {
+      pattern_anchors_t anchors { pattern.size( ), pattern.size( ) };
+      for ( std::size_t i = 0; i < pattern.size( ); i++ ) {
+        if ( pattern.mask[ i ] == 0x00 )
+          continue;
+
+        const auto frequency = byte_frequency( pattern.bytes[ i ] );
+        if ( anchors.first == pattern.size( ) ||
+             frequency < byte_frequency( pattern.bytes[ anchors.first ] ) ) {
+          anchors.second = anchors.first;
+          anchors.first  = i;
+        } else if ( anchors.second == pattern.size( ) ||
+                    frequency < byte_frequency( pattern.bytes[ anchors.second ] ) ) {
+          anchors.second = i;
+        }
+      }
+      if ( anchors.second == pattern.size( ) )
+        anchors.second = anchors.first;
+      return anchors;
+    }
+
+    /**
+     * Check if pattern matches at the given position, comparing 8 bytes at a time.
+     * @param data position to check, at least pattern.size() bytes have to be readable.
+     * @param pattern pattern to match.
+     * @return true if pattern matches, false otherwise.
+     */
+    [[nodiscard]] inline bool verify_pattern( const std::uint8_t * data, const pattern_t & pattern ) {
+      const auto  length = pattern.size( );
+      std::size_t i      = 0;
+      for ( ; i + 8 <= length; i += 8 ) {
+        std::uint64_t value, bytes, mask;
+        std::memcpy( &value, data + i, 8 );
+        std::memcpy( &bytes, pattern.bytes.data( ) + i, 8 );
+        std::memcpy( &mask, pattern.mask.data( ) + i, 8 );
+        if ( ( ( value ^ bytes ) & mask ) != 0 )
+          return false;
+      }
+      for ( ; i < length; i++ )
+        if ( ( ( data[ i ] ^ pattern.bytes[ i ] ) & pattern.mask[ i ] ) != 0 )
+          return false;
+      return true;
+    }
+
+    /**
+     * Scalar pattern search, anchored with memchr on the rarest concrete byte.
+     * See match_pattern.
+     */
+    template <typename F>
+    void match_pattern_scalar( const std::uint8_t * data,
+                               std::size_t          size,
+                               const pattern_t &    pattern,
+                               std::size_t          offset,
+                               F &&                 on_match ) {
+      const auto length = pattern.size( );
+      if ( length == 0 || size < length )
+        return;
+
+      const auto        anchor = select_anchors( pattern ).first;
+      const std::size_t last   = size - length;
+      while ( offset <= last ) {
+        const auto found = static_cast<const std::uint8_t *>(
+            std::memchr( data + offset + anchor, pattern.bytes[ anchor ], last - offset + 1 ) );
+        if ( found == nullptr )
+          return;
+
+        offset = static_cast<std::size_t>( found - data ) - anchor;
+        if ( verify_pattern( data + offset, pattern ) && !on_match( offset ) )
+          return;
+        offset++;
+      }
+    }
+
+#ifdef TRICKSTER_X86_SIMD
+    /**
+     * SSE2 pattern search. Both anchors are compared for 16 candidate positions
+     * at once, surviving candidates are verified with verify_pattern.
+     * See match_pattern.
+     */
+    template <typename F>
+    __attribute__( ( target( "sse2" ) ) ) void
+    match_pattern_sse2( const std::uint8_t * data,
+                        std::size_t          size,
+                        const pattern_t &    pattern,
+                        F &&                 on_match ) {
+      const auto length = pattern.size( );
+      if ( length == 0 || size < length )
+        return;
+
+      const auto        anchors = select_anchors( pattern );
+      const std::size_t last    = size - length;
+      const __m128i     first   = _mm_set1_epi8( static_cast<char>( pattern.bytes[ anchors.first ] ) );
+      const __m128i     second  = _mm_set1_epi8( static_cast<char>( pattern.bytes[ anchors.second ] ) );
+
+      std::size_t offset = 0;
+      for ( ; offset + 16 <= last + 1; offset += 16 ) {
+        const __m128i first_block =
+            _mm_loadu_si128( reinterpret_cast<const __m128i *>( data + offset + anchors.first ) );
+        const __m128i second_block =
+            _mm_loadu_si128( reinterpret_cast<const __m128i *>( data + offset + anchors.second ) );
+
+        auto candidates = static_cast<std::uint32_t>( _mm_movemask_epi8(
+            _mm_and_si128( _mm_cmpeq_epi8( first_block, first ), _mm_cmpeq_epi8( second_block, second ) ) ) );
+        while ( candidates != 0 ) {
+          const auto candidate = offset + static_cast<std::size_t>( __builtin_ctz( candidates ) );
+          if ( verify_pattern( data + candidate, pattern ) && !on_match( candidate ) )
+            return;
+          candidates &= candidates - 1;
+        }
+      }
+
+      match_pattern_scalar( data, size, pattern, offset, on_match );
+    }
+
+    /**
+     * AVX2 pattern search, same as match_pattern_sse2 for 32 candidate positions at once.
+     * See match_pattern.
+     */
+    template <typename F>
+    __attribute__( ( target( "avx2" ) ) ) void
+    match_pattern_avx2( const std::uint8_t * data,
+                        std::size_t          size,
+                        const pattern_t &    pattern,
+                        F &&                 on_match ) {
+      const auto length = pattern.size( );
+      if ( length == 0 || size < length )
+        return;
+
+      const auto        anchors = select_anchors( pattern );
+      const std::size_t last    = size - length;
+      const __m256i     first   = _mm256_set1_epi8( static_cast<char>( pattern.bytes[ anchors.first ] ) );
+      const __m256i     second  = _mm256_set1_epi8( static_cast<char>( pattern.bytes[ anchors.second ] ) );
+
+      std::size_t offset = 0;
+      for ( ; offset + 32 <= last + 1; offset += 32 ) {
+        const __m256i first_block =
+            _mm256_loadu_si256( reinterpret_cast<const __m256i *>( data + offset + anchors.first ) );
+        const __m256i second_block =
+            _mm256_loadu_si256( reinterpret_cast<const __m256i *>( data + offset + anchors.second ) );
+
+        auto candidates = static_cast<std::uint32_t>( _mm256_movemask_epi8( _mm256_and_si256(
+            _mm256_cmpeq_epi8( first_block, first ), _mm256_cmpeq_epi8( second_block, second ) ) ) );
+        while ( candidates != 0 ) {
+          const auto candidate = offset + static_cast<std::size_t>( __builtin_ctz( candidates ) );
+          if ( verify_pattern( data + candidate, pattern ) && !on_match( candidate ) )
+            return;
+          candidates &= candidates - 1;
+        }
+      }
+
+      match_pattern_scalar( data, size, pattern, offset, on_match );
+    }
+
+    /**
+     * Check if CPU supports AVX2, result is cached.
+     * @return state of statement above.
+     */
+    [[nodiscard]] inline bool cpu_has_avx2( ) {
+      static const bool supported = [ ] {
+        __builtin_cpu_init( );
+        return __builtin_cpu_supports( "avx2" ) != 0;
+      }( );
+      return supported;
+    }
+#endif
+
+    /**
+     * Find all occurrences of pattern in local buffer.
+     * Dispatches at runtime to the widest kernel supported by CPU (AVX2, SSE2
+     * or scalar). Define TRICKSTER_NO_SIMD to always use the scalar kernel.
+     * @param data buffer to search.
+     * @param size size of the buffer.
+     * @param pattern pattern to find.
+     * @param on_match invoked with offset of each match in increasing order,
+     * returning false stops the search.
+     */
+    template <typename F>
+    void match_pattern( const std::uint8_t * data,
+                        std::size_t          size,
+                        const pattern_t &    pattern,
+                        F &&                 on_match ) {
+#ifdef TRICKSTER_X86_SIMD
+      if ( cpu_has_avx2( ) )
+        return match_pattern_avx2( data, size, pattern, on_match );
+      return match_pattern_sse2( data, size, pattern, on_match );
+#else
+      return match_pattern_scalar( data, size, pattern, 0, on_match );
+#endif
+    }
+  } // namespace _internal
+
+  namespace utils {
+    /**
+     * Find all occurrences of pattern in local buffer, e.g. a chunk of remote
+     * memory that was already read or a module file mapped from disk.
+     * @param data buffer to search.
+     * @param size size of the buffer.
+     * @param pattern pattern to find.
+     * @param limit maximum number of results, 0 means no limit.
+     * @return offsets of matches in increasing order.
+     */
+    [[nodiscard]] inline std::vector<std::size_t>
+    find_pattern( const void * data, std::size_t size, const pattern_t & pattern, std::size_t limit = 0 ) {
+      std::vector<std::size_t> offsets;
+      const auto bytes = static_cast<const std::uint8_t *>( data );
+      _internal::match_pattern( bytes, size, pattern, [ & ]( std::size_t offset ) {
+        offsets.push_back( offset );
+        return limit == 0 || offsets.size( ) < limit;
+      } );
+      return offsets;
+    }
+  } // namespace utils
+
+  /**
+   * Remote memory cache options.
+   */
+  struct cache_options_t {
+    /**
+     * Size of cached line, has to be a power of 2. Lines are aligned to their size.
+     */
+    std::size_t line_size = 4096;
+
+    /**
+     * Maximum number of cached lines, least recently used line is evicted when full.
+     */
+    std::size_t capacity = 1024;
+
+    /**
+     * Lines older than this are fetched again, 0 disables expiration and
+     * lines are invalidated only by process_t::begin_frame.
+     */
+    std::chrono::steady_clock::duration ttl { 0 };
+  };
+
+  /**
+   * Remote memory cache counters.
+   */
+  struct cache_stats_t {
+    std::uint64_t hits, misses, evictions, invalidations;
+  };
+
+  namespace _internal {
+    /**
+     * LRU cache of remote memory lines. Lines are valid for the generation
+     * they were fetched in, so bumping the generation drops all of them in O(1).
+     * Not synchronized, owner locks mutex around every use.
+     */
+    class page_cache_t {
+    public:
+      constexpr static std::uint32_t npos = UINT32_MAX;
+
+    private:
+      struct line_t {
+        std::uintptr_t                        address;
+        std::uint64_t                         generation;
+        std::chrono::steady_clock::time_point fetched;
+        std::size_t                           valid;
+        std::uint32_t                         previous, next;
+      };
+
+      cache_options_t                                 m_options;
+      std::vector<line_t>                             m_lines;
+      std::vector<std::uint8_t>                       m_data;
+      std::unordered_map<std::uintptr_t, std::uint32_t> m_index;
+      std::uint32_t                                   m_head = npos, m_tail = npos;
+      std::uint64_t                                   m_generation = 0;
+      cache_stats_t                                   m_stats { };
+
+      void unlink( std::uint32_t slot ) {
+        auto & line = m_lines[ slot ];
+        ( line.previous != npos ? m_lines[ line.previous ].next : m_head ) = line.next;
+        ( line.next != npos ? m_lines[ line.next ].previous : m_tail )     = line.previous;
+      }
+
+      void push_front( std::uint32_t slot ) {
+        auto & line    = m_lines[ slot ];
+        line.previous  = npos;
+        line.next      = m_head;
+        if ( m_head != npos )
+          m_lines[ m_head ].previous = slot;
+        m_head = slot;
+        if ( m_tail == npos )
+          m_tail = slot;
+      }
+
+      [[nodiscard]] bool fresh( const line_t & line ) const {
+        if ( line.generation != m_generation )
+          return false;
+        return m_options.ttl.count( ) == 0 ||
+               std::chrono::steady_clock::now( ) - line.fetched < m_options.ttl;
+      }
+
+    public:
+      std::mutex mutex;
+
+      /**
+       * Scratch of process_t::read_cached, reused under the mutex so cached reads do not allocate.
+       */
+      std::vector<std::uint32_t> slots;
+      std::vector<read_entry_t>  missing;
+      std::vector<std::size_t>   bytes_read;
+
+      explicit page_cache_t( const cache_options_t & options ) : m_options( options ) {
+        tr_assert( ( options.line_size & ( options.line_size - 1 ) ) == 0,
+                   tr_string( "Cache line size is not a power of 2." ) );
+        tr_assert( options.capacity > 0, tr_string( "Cache capacity is 0." ) );
+        m_lines.reserve( options.capacity );
+        m_data.resize( options.capacity * options.line_size );
+        m_index.reserve( options.capacity );
+      }
+
+      [[nodiscard]] const cache_options_t & options( ) const noexcept { return m_options; }
+
+      [[nodiscard]] cache_stats_t stats( ) const noexcept { return m_stats; }
+
+      [[nodiscard]] std::uintptr_t line_of( std::uintptr_t address ) const noexcept {
+        return address & ~( static_cast<std::uintptr_t>( m_options.line_size ) - 1 );
+      }
+
+      [[nodiscard]] std::uint8_t * data( std::uint32_t slot ) noexcept {
+        return m_data.data( ) + static_cast<std::size_t>( slot ) * m_options.line_size;
+      }
+
+      [[nodiscard]] std::size_t valid( std::uint32_t slot ) const noexcept { return m_lines[ slot ].valid; }
+
+      /**
+       * Find fresh line and mark it as most recently used.
+       * @param address line address.
+       * @return slot of the line or npos if line is not cached.
+       */
+      [[nodiscard]] std::uint32_t find( std::uintptr_t address ) {
+        const auto entry = m_index.find( address );
+        if ( entry == m_index.end( ) || !fresh( m_lines[ entry->second ] ) ) {
+          m_stats.misses++;
+          return npos;
+        }
+
+        m_stats.hits++;
+        unlink( entry->second );
+        push_front( entry->second );
+        return entry->second;
+      }
+
+      /**
+       * Get slot for the line, evicting least recently used line if needed.
+       * Slot has to be filled and committed by the caller.
+       * @param address line address.
+       * @return slot for the line.
+       */
+      [[nodiscard]] std::uint32_t acquire( std::uintptr_t address ) {
+        std::uint32_t slot;
+        if ( const auto entry = m_index.find( address ); entry != m_index.end( ) ) {
+          slot = entry->second;
+          unlink( slot );
+        } else if ( m_lines.size( ) < m_options.capacity ) {
+          slot = static_cast<std::uint32_t>( m_lines.size( ) );
+          m_lines.push_back( { } );
+        } else {
+          slot = m_tail;
+          unlink( slot );
+          m_index.erase( m_lines[ slot ].address );
+          m_stats.evictions++;
+        }
+
+        m_lines[ slot ].address = address;
+        m_lines[ slot ].valid   = 0;
+        m_index[ address ]      = slot;
+        push_front( slot );
+        return slot;
+      }
+
+      /**
+       * Mark acquired line as fetched.
+       * @param slot slot returned by acquire.
+       * @param valid number of bytes that were read, 0 drops the line.
+       */
+      void commit( std::uint32_t slot, std::size_t valid ) {
+        auto & line = m_lines[ slot ];
+        if ( valid == 0 ) {
+          line.generation = m_generation - 1;
+          return;
+        }
+        line.valid      = valid;
+        line.generation = m_generation;
+        line.fetched    = std::chrono::steady_clock::now( );
+      }
+
+      /**
+       * Update cached bytes after they were written to the process.
+       * @param address starting address of written bytes.
+       * @param data written bytes.
+       * @param size number of written bytes.
+       */
+      void update( std::uintptr_t address, const void * data, std::size_t size ) {
+        const auto bytes = static_cast<const std::uint8_t *>( data );
+        for ( auto line_address = line_of( address ); line_address < address + size;
+              line_address += m_options.line_size ) {
+          const auto entry = m_index.find( line_address );
+          if ( entry == m_index.end( ) )
+            continue;
+
+          const auto begin = std::max( address, line_address );
+          const auto end   = std::min( address + size, line_address + m_lines[ entry->second ].valid );
+          if ( begin < end )
+            std::memcpy( this->data( entry->second ) + ( begin - line_address ),
+                         bytes + ( begin - address ),
+                         end - begin );
+        }
+      }
+
+      /**
+       * Drop cached lines overlapping the range.
+       * @param address starting address.
+       * @param size size of the range.
+       */
+      void invalidate( std::uintptr_t address, std::size_t size ) {
+        for ( auto line_address = line_of( address ); line_address < address + size;
+              line_address += m_options.line_size ) {
+          const auto entry = m_index.find( line_address );
+          if ( entry == m_index.end( ) )
+            continue;
+          m_lines[ entry->second ].generation = m_generation - 1;
+          m_stats.invalidations++;
+        }
+      }
+
+      /**
+       * Drop all cached lines.
+       */
+      void invalidate_all( ) {
+        m_generation++;
+        m_stats.invalidations++;
+      }
+    };
+  } // namespace _internal
+
+  /**
+   * Region permission bits of packed region representations.
+   */
+  struct region_permissions_t {
+    constexpr static std::uint8_t readable = 1 << 0, writable = 1 << 1, executable = 1 << 2, shared = 1 << 3;
+
+    /**
+     * Pack permissions of the region.
+     * @param region memory region.
+     * @return permission bits.
+     */
+    [[nodiscard]] static constexpr std::uint8_t of( const memory_region_t & region ) noexcept {
+      return ( region.readable ? readable : 0 ) | ( region.writable ? writable : 0 ) |
+             ( region.executable ? executable : 0 ) | ( region.shared ? shared : 0 );
+    }
+  };
+
+  /**
+   * Address to region lookup index answering queries in O(log n).
+   * Start addresses are stored in Eytzinger (BFS) order, so the binary search
+   * walks the array front to back and its first levels share cache lines.
+   * Ends and permissions are kept in separate arrays, so queries touch only
+   * what they need and never the memory_region_t structures.
+   */
+  class region_index_t {
+  public:
+    constexpr static std::size_t npos = SIZE_MAX;
+
+  private:
+    const std::vector<memory_region_t> * m_regions = nullptr;
+    // 1-based Eytzinger order, element 0 is unused.
+    std::vector<std::uint64_t> m_starts;
+    std::vector<std::uint32_t> m_positions;
+    // Sorted order.
+    std::vector<std::uint64_t> m_ends;
+    std::vector<std::uint8_t>  m_permissions;
+
+    std::size_t fill( std::size_t sorted, std::size_t node, const std::vector<memory_region_t> & regions ) {
+      if ( node < m_starts.size( ) ) {
+        sorted               = fill( sorted, 2 * node, regions );
+        m_starts[ node ]     = regions[ sorted ].start;
+        m_positions[ node ]  = static_cast<std::uint32_t>( sorted );
+        sorted               = fill( sorted + 1, 2 * node + 1, regions );
+      }
+      return sorted;
+    }
+
+  public:
+    /**
+     * Build index over regions, reusing previously allocated storage.
+     * @param regions regions sorted by start address, as produced by map_memory_regions.
+     * Index refers to them, so they have to outlive it and stay unmodified.
+     */
+    void build( const std::vector<memory_region_t> & regions ) {
+      m_regions = &regions;
+      m_starts.resize( regions.size( ) + 1 );
+      m_positions.resize( regions.size( ) + 1 );
+      m_ends.resize( regions.size( ) );
+      m_permissions.resize( regions.size( ) );
+
+      for ( std::size_t i = 0; i < regions.size( ); i++ ) {
+        m_ends[ i ]        = regions[ i ].end;
+        m_permissions[ i ] = region_permissions_t::of( regions[ i ] );
+      }
+      fill( 0, 1, regions );
+    }
+
+    /**
+     * Find index of region containing address.
+     * @param address address to look up.
+     * @return index of the region in the indexed vector or npos.
+     */
+    [[nodiscard]] std::size_t find( std::uintptr_t address ) const noexcept {
+      const auto count = m_ends.size( );
+      if ( count == 0 )
+        return npos;
+
+      // Descend to the first start greater than address.
+      std::size_t node = 1;
+      while ( node <= count )
+        node = 2 * node + ( m_starts[ node ] <= address );
+      node >>= __builtin_ffsll( static_cast<long long>( ~node ) );
+
+      const std::size_t upper = node == 0 ? count : m_positions[ node ];
+      if ( upper == 0 )
+        return npos;
+
+      const auto index = upper - 1;
+      return address < m_ends[ index ] ? index : npos;
+    }
+
+    /**
+     * Find region containing address.
+     * @param address address to look up.
+     * @return pointer to the region or nullptr if address is not mapped.
+     */
+    [[nodiscard]] const memory_region_t * find_region( std::uintptr_t address ) const noexcept {
+      const auto index = find( address );
+      return index == npos ? nullptr : &( *m_regions )[ index ];
+    }
+
+    /**
+     * Check if every byte of the range is mapped with all given permissions.
+     * Range can span multiple adjacent regions.
+     * @param address starting address.
+     * @param size size of the range.
+     * @param permissions required region_permissions_t bits.
+     * @return state of statement above.
+     */
+    [[nodiscard]] bool
+    has_permissions( std::uintptr_t address, std::size_t size, std::uint8_t permissions ) const {
+      auto index = find( address );
+      if ( index == npos )
+        return false;
+
+      const auto end = address + size;
+      for ( ;; ) {
+        if ( ( m_permissions[ index ] & permissions ) != permissions )
+          return false;
+        if ( end <= m_ends[ index ] )
+          return true;
+        if ( index + 1 == m_ends.size( ) || ( *m_regions )[ index + 1 ].start != m_ends[ index ] )
+          return false;
+        index++;
+      }
+    }
+
+    /**
+     * Check if range is readable.
+     * @param address starting address.
+     * @param size size of the range.
+     * @return state of statement above.
+     */
+    [[nodiscard]] bool is_readable( std::uintptr_t address, std::size_t size = 1 ) const {
+      return has_permissions( address, size, region_permissions_t::readable );
+    }
+
+    /**
+     * Check if range is writable.
+     * @param address starting address.
+     * @param size size of the range.
+     * @return state of statement above.
+     */
+    [[nodiscard]] bool is_writable( std::uintptr_t address, std::size_t size = 1 ) const {
+      return has_permissions( address, size, region_permissions_t::writable );
+    }
+
+    /**
+     * Get filename of module containing address.
+     * @param address address to look up.
+     * @return filename of the mapped file or special region name, empty if
+     * address is not mapped or region is anonymous.
+     */
+    [[nodiscard]] std::string_view module_of( std::uintptr_t address ) const noexcept {
+      const auto region = find_region( address );
+      return region ? std::string_view { region->filename } : std::string_view { };
+    }
+
+    /**
+     * Get number of indexed regions.
+     * @return number of regions.
+     */
+    [[nodiscard]] std::size_t size( ) const noexcept { return m_ends.size( ); }
+  };
+
+  /**
+   * Compact structure of arrays snapshot of memory regions.
+   * Every field is a separate column, so range scans touch only the columns
+   * they need. Paths are interned, each distinct path is stored once and
+   * regions refer to it by small integer id (0 for anonymous regions).
+   * Interned paths are kept when snapshot is mapped again, so repeated
+   * mapping into the same snapshot does not allocate for known paths.
+   */
+  class region_snapshot_t {
+  public:
+    std::vector<std::uint64_t> starts, ends, offsets, inodes;
+    /**
+     * Device numbers packed as major << 20 | minor.
+     */
+    std::vector<std::uint32_t> devices;
+    /**
+     * region_permissions_t bits.
+     */
+    std::vector<std::uint8_t>  permissions;
+    std::vector<std::uint32_t> path_ids;
+
+  private:
+    std::deque<std::string>                         m_paths { std::string { } };
+    std::unordered_map<std::string_view, std::uint32_t> m_path_ids { { std::string_view { }, 0 } };
+
+  public:
+    region_snapshot_t( )                                       = default;
+    region_snapshot_t( const region_snapshot_t & )             = delete;
+    region_snapshot_t & operator=( const region_snapshot_t & ) = delete;
+    region_snapshot_t( region_snapshot_t && )                  = default;
+    region_snapshot_t & operator=( region_snapshot_t && )      = default;
+
+    /**
+     * Intern path.
+     * @param path path to intern.
+     * @return id of the path.
+     */
+    std::uint32_t intern( std::string_view path ) {
+      if ( const auto entry = m_path_ids.find( path ); entry != m_path_ids.end( ) )
+        return entry->second;
+
+      const auto id = static_cast<std::uint32_t>( m_paths.size( ) );
+      m_paths.emplace_back( path );
+      m_path_ids.emplace( m_paths.back( ), id );
+      return id;
+    }
+
+    /**
+     * Append decoded maps row.
+     * @param entry decoded maps row.
+     */
+    void push_back( const _internal::maps_entry_t & entry ) {
+      starts.push_back( entry.start );
+      ends.push_back( entry.end );
+      offsets.push_back( entry.offset );
+      inodes.push_back( entry.inode );
+      devices.push_back( static_cast<std::uint32_t>( entry.device_major << 20 | entry.device_minor ) );
+      permissions.push_back( ( entry.readable ? region_permissions_t::readable : 0 ) |
+                             ( entry.writable ? region_permissions_t::writable : 0 ) |
+                             ( entry.executable ? region_permissions_t::executable : 0 ) |
+                             ( entry.shared ? region_permissions_t::shared : 0 ) );
+      path_ids.push_back( intern( entry.pathname ) );
+    }
+
+    /**
+     * Remove all regions, interned paths are kept.
+     */
+    void clear( ) {
+      starts.clear( );
+      ends.clear( );
+      offsets.clear( );
+      inodes.clear( );
+      devices.clear( );
+      permissions.clear( );
+      path_ids.clear( );
+    }
+
+    /**
+     * Get number of regions.
+     * @return number of regions.
+     */
+    [[nodiscard]] std::size_t size( ) const noexcept { return starts.size( ); }
+
+    /**
+     * Get number of interned paths, including the empty one.
+     * @return number of distinct paths.
+     */
+    [[nodiscard]] std::size_t path_count( ) const noexcept { return m_paths.size( ); }
+
+    /**
+     * Get interned path by id.
+     * @param id path id.
+     * @return path, empty for anonymous regions.
+     */
+    [[nodiscard]] std::string_view path( std::uint32_t id ) const { return m_paths[ id ]; }
+
+    /**
+     * Get path of region.
+     * @param index region index.
+     * @return path, empty for anonymous regions.
+     */
+    [[nodiscard]] std::string_view region_path( std::size_t index ) const {
+      return m_paths[ path_ids[ index ] ];
+    }
+
+    /**
+     * Find index of region containing address using binary search over starts column.
+     * @param address address to look up.
+     * @return index of the region or SIZE_MAX if address is not mapped.
+     */
+    [[nodiscard]] std::size_t find( std::uintptr_t address ) const noexcept {
+      const auto upper = std::upper_bound( starts.begin( ), starts.end( ), address );
+      if ( upper == starts.begin( ) )
+        return SIZE_MAX;
+      const auto index = static_cast<std::size_t>( upper - starts.begin( ) ) - 1;
+      return address < ends[ index ] ? index : SIZE_MAX;
+    }
+
+    /**
+     * Convert region to memory_region_t.
+     * @param index region index.
+     * @return memory region.
+     */
+    [[nodiscard]] memory_region_t to_region( std::size_t index ) const {
+      _internal::maps_entry_t entry;
+      entry.start        = starts[ index ];
+      entry.end          = ends[ index ];
+      entry.readable     = permissions[ index ] & region_permissions_t::readable;
+      entry.writable     = permissions[ index ] & region_permissions_t::writable;
+      entry.executable   = permissions[ index ] & region_permissions_t::executable;
+      entry.shared       = permissions[ index ] & region_permissions_t::shared;
+      entry.offset       = offsets[ index ];
+      entry.device_major = devices[ index ] >> 20;
+      entry.device_minor = devices[ index ] & ( ( 1u << 20 ) - 1 );
+      entry.inode        = inodes[ index ];
+      entry.pathname     = region_path( index );
+      return _internal::to_memory_region( entry );
+    }
+
+    /**
+     * Convert all regions to memory_region_t.
+     * @return memory regions.
+     */
+    [[nodiscard]] std::vector<memory_region_t> to_regions( ) const {
+      std::vector<memory_region_t> regions;
+      regions.reserve( size( ) );
+      for ( std::size_t i = 0; i < size( ); i++ )
+        regions.push_back( to_region( i ) );
+      return regions;
+    }
+  };
+
+  /**
+   * Mapped segment of module.
+   */
+  struct module_segment_t {
+    std::uint64_t start, end, offset;
+    /**
+     * region_permissions_t bits.
+     */
+    std::uint8_t permissions;
+  };
+
+  /**
+   * Module, file mapped into the process address space.
+   */
+  struct module_t {
+    /**
+     * Interned filename and full path, owned by the module table.
+     */
+    std::string_view name, path;
+    /**
+     * Lowest mapped address and end of the highest mapped segment.
+     */
+    std::uint64_t base, end;
+    std::uint64_t inode;
+    int           device_major, device_minor;
+    /**
+     * Range of the module segments in module_table_t::segments.
+     */
+    std::uint32_t first_segment, segment_count;
+
+    /**
+     * Get total span of the module.
+     * @return size of the module in bytes.
+     */
+    [[nodiscard]] std::uint64_t size( ) const noexcept { return end - base; }
+  };
+
+  /**
+   * Table of modules grouped from file backed regions, with name lookup in O(1).
+   * Every file backed region (special and anonymous regions are skipped) belongs
+   * to the module of its path, regions of one file do not have to be adjacent.
+   * When a file is mapped more than once (mapping starts at offset 0 again), the
+   * mapping with an executable segment is the module and the others are skipped.
+   * Names are interned and kept between builds, so rebuilding the table after
+   * remapping does not allocate for modules that were already seen.
+   */
+  class module_table_t {
+  private:
+    std::vector<module_t>                               m_modules;
+    std::vector<module_segment_t>                       m_segments;
+    std::vector<std::uint32_t>                          m_region_modules;
+    std::deque<std::string>                             m_paths;
+    std::unordered_map<std::string_view, std::uint32_t> m_path_ids;
+    std::vector<std::uint32_t>                          m_path_modules;
+    std::vector<std::uint8_t>                           m_path_states;
+    std::unordered_map<std::string_view, std::uint32_t> m_lookup;
+
+    // Per path flags: module has executable segment, current mapping of the file is skipped.
+    constexpr static std::uint8_t mapping_executable = 1, mapping_skipped = 2;
+
+    constexpr static std::uint32_t none = UINT32_MAX;
+
+    std::string_view intern( std::string_view path, std::uint32_t & id ) {
+      if ( const auto entry = m_path_ids.find( path ); entry != m_path_ids.end( ) ) {
+        id = entry->second;
+        return m_paths[ id ];
+      }
+
+      id = static_cast<std::uint32_t>( m_paths.size( ) );
+      m_paths.emplace_back( path );
+      m_path_ids.emplace( m_paths.back( ), id );
+      m_path_modules.push_back( none );
+      m_path_states.push_back( 0 );
+      return m_paths.back( );
+    }
+
+  public:
+    /**
+     * Build table from regions, reusing previously allocated storage.
+     * @param regions regions sorted by start address, as produced by map_memory_regions.
+     */
+    void build( const std::vector<memory_region_t> & regions ) {
+      m_modules.clear( );
+      m_segments.clear( );
+      m_lookup.clear( );
+      m_region_modules.assign( regions.size( ), none );
+      std::fill( m_path_modules.begin( ), m_path_modules.end( ), none );
+      std::fill( m_path_states.begin( ), m_path_states.end( ), 0 );
+
+      // Group regions by path, segment_count counts segments of the module for now.
+      for ( std::size_t i = 0; i < regions.size( ); i++ ) {
+        const auto & region = regions[ i ];
+        if ( region.inode == 0 || region.special || region.path.empty( ) )
+          continue;
+
+        std::uint32_t id;
+        const auto    path  = intern( region.path.native( ), id );
+        auto &        state = m_path_states[ id ];
+        if ( m_path_modules[ id ] != none && region.offset == 0 ) {
+          // Another mapping of the same file, keep the loaded (executable) one.
+          if ( state & mapping_executable ) {
+            state |= mapping_skipped;
+            continue;
+          }
+          const auto previous = m_path_modules[ id ];
+          for ( std::size_t j = 0; j < i; j++ )
+            if ( m_region_modules[ j ] == previous )
+              m_region_modules[ j ] = none;
+          m_modules[ previous ].base          = region.start;
+          m_modules[ previous ].end           = region.end;
+          m_modules[ previous ].segment_count = 0;
+        } else if ( state & mapping_skipped ) {
+          continue;
+        }
+
+        if ( m_path_modules[ id ] == none ) {
+          m_path_modules[ id ] = static_cast<std::uint32_t>( m_modules.size( ) );
+
+          module_t module;
+          module.path          = path;
+          module.name          = _internal::filename_of( path );
+          module.base          = region.start;
+          module.end           = region.end;
+          module.inode         = region.inode;
+          module.device_major  = region.device_major;
+          module.device_minor  = region.device_minor;
+          module.first_segment = 0;
+          module.segment_count = 0;
+          m_modules.push_back( module );
+        }
+
+        auto & module         = m_modules[ m_path_modules[ id ] ];
+        module.end            = std::max<std::uint64_t>( module.end, region.end );
+        m_region_modules[ i ] = m_path_modules[ id ];
+        module.segment_count++;
+        if ( region.executable )
+          state |= mapping_executable;
+      }
+
+      // Lay out segments of every module contiguously, in address order.
+      std::uint32_t first = 0;
+      for ( auto & module : m_modules ) {
+        module.first_segment = first;
+        first += module.segment_count;
+        module.segment_count = 0;
+      }
+      m_segments.resize( first );
+      for ( std::size_t i = 0; i < regions.size( ); i++ ) {
+        if ( m_region_modules[ i ] == none )
+          continue;
+        auto & module = m_modules[ m_region_modules[ i ] ];
+        const auto & region = regions[ i ];
+        m_segments[ module.first_segment + module.segment_count++ ] = {
+            region.start, region.end, region.offset, region_permissions_t::of( region ) };
+      }
+
+      // First module with given name wins, full paths are always unique.
+      for ( std::size_t i = 0; i < m_modules.size( ); i++ ) {
+        m_lookup.emplace( m_modules[ i ].name, static_cast<std::uint32_t>( i ) );
+        m_lookup.emplace( m_modules[ i ].path, static_cast<std::uint32_t>( i ) );
+      }
+    }
+
+    /**
+     * Find module by filename or full path.
+     * @param name filename (e.g. libc.so.6) or full path of the module.
+     * @return pointer to the module or nullptr if no such module is mapped.
+     */
+    [[nodiscard]] const module_t * find( std::string_view name ) const {
+      const auto entry = m_lookup.find( name );
+      return entry == m_lookup.end( ) ? nullptr : &m_modules[ entry->second ];
+    }
+
+    /**
+     * Get base address of module.
+     * @param name filename (e.g. libc.so.6) or full path of the module.
+     * @return base address or std::nullopt if no such module is mapped.
+     */
+    [[nodiscard]] std::optional<std::uintptr_t> module_base( std::string_view name ) const {
+      const auto module = find( name );
+      if ( !module )
+        return std::nullopt;
+      return static_cast<std::uintptr_t>( module->base );
+    }
+
+    /**
+     * Get segments of module.
+     * @param module module of this table.
+     * @return pointer to the first segment, module.segment_count segments follow.
+     */
+    [[nodiscard]] const module_segment_t * segments( const module_t & module ) const noexcept {
+      return m_segments.data( ) + module.first_segment;
+    }
+
+    /**
+     * Get modules ordered by base address.
+     * @return modules.
+     */
+    [[nodiscard]] const std::vector<module_t> & modules( ) const noexcept { return m_modules; }
+
+    /**
+     * Get number of modules.
+     * @return number of modules.
+     */
+    [[nodiscard]] std::size_t size( ) const noexcept { return m_modules.size( ); }
+  };
+
+  namespace _internal {
+    /**
+     * Check if range intersects any of the ranges.
+     * @param ranges sorted, non overlapping ranges.
+     * @param start start of the range.
+     * @param end end of the range.
+     * @return state of statement above.
+     */
+    [[nodiscard]] inline bool intersects( const std::vector<page_range_t> & ranges,
+                                          std::uintptr_t                    start,
+                                          std::uintptr_t                    end ) noexcept {
+      const auto range = std::upper_bound(
+          ranges.begin( ), ranges.end( ), start, []( std::uintptr_t value, const page_range_t & candidate ) {
+            return value < candidate.end;
+          } );
+      return range != ranges.end( ) && range->start < end;
+    }
+  } // namespace _internal
+
+  /**
+   * Snapshot options.
+   */
+  struct snapshot_options_t {
+    /**
+     * Snapshot only writable regions.
+     */
+    bool writable_only = false;
+
+    /**
+     * Store identical pages once.
+     */
+    bool deduplicate = true;
+
+    /**
+     * Size of memory read at once, multiple of the page size.
+     */
+    std::size_t chunk_size = 1 << 20;
+
+    /**
+     * Capture only pages intersecting these sorted ranges, e.g. dirty pages
+     * collected by dirty_tracker_t. Other pages are recorded as unreadable.
+     */
+    const std::vector<page_range_t> * ranges = nullptr;
+  };
+
+  namespace _internal {
+    /**
+     * Snapshot file layout: header, region table, path strings, page table
+     * with one entry per page of every region, and page aligned page data.
+     */
+    struct snapshot_header_t {
+      char          magic[ 8 ];
+      std::uint32_t version, page_size;
+      std::int32_t  pid;
+      std::uint32_t region_count;
+      std::uint64_t page_count, data_page_count;
+      std::uint64_t regions_offset, paths_offset, pages_offset, data_offset;
+      /**
+       * Time the snapshot was taken at, nanoseconds since epoch.
+       */
+      std::uint64_t timestamp;
+    };
+
+    constexpr char          snapshot_magic[ 8 ] = { 'T', 'R', 'S', 'N', 'A', 'P', '\0', '\0' };
+    constexpr std::uint32_t snapshot_version    = 1;
+
+    /**
+     * Hash page contents, four independent lanes keep multiplies in flight.
+     * @param data page contents.
+     * @param size page size, multiple of 32.
+     * @return 64 bit hash.
+     */
+    [[nodiscard]] inline std::uint64_t hash_page( const std::uint8_t * data, std::size_t size ) noexcept {
+      constexpr std::uint64_t prime = 0x9E3779B97F4A7C15;
+      std::uint64_t           lanes[ 4 ] = { prime, prime ^ 1, prime ^ 2, prime ^ 3 };
+
+      for ( std::size_t offset = 0; offset < size; offset += sizeof( lanes ) ) {
+        for ( std::size_t lane = 0; lane < 4; lane++ ) {
+          std::uint64_t word;
+          std::memcpy( &word, data + offset + lane * sizeof( word ), sizeof( word ) );
+          lanes[ lane ] = ( lanes[ lane ] ^ word ) * 0xFF51AFD7ED558CCD;
+          lanes[ lane ] ^= lanes[ lane ] >> 32;
+        }
+      }
+
+      std::uint64_t hash = size;
+      for ( const auto lane : lanes )
+        hash = ( hash ^ lane ) * prime;
+      return hash ^ hash >> 29;
+    }
+
+    /**
+     * Write whole buffer to file at offset.
+     * @param fd file descriptor.
+     * @param data data to write.
+     * @param size size of the data.
+     * @param offset file offset.
+     * @return true if everything was written, false otherwise.
+     */
+    inline bool pwrite_all( int fd, const void * data, std::size_t size, std::uint64_t offset ) {
+      auto position = static_cast<const std::uint8_t *>( data );
+      while ( size != 0 ) {
+        const auto result = pwrite( fd, position, size, static_cast<off_t>( offset ) );
+        if ( result < 0 && errno == EINTR )
+          continue;
+        if ( result <= 0 )
+          return false;
+        position += result;
+        offset += static_cast<std::uint64_t>( result );
+        size -= static_cast<std::size_t>( result );
+      }
+      return true;
+    }
+  } // namespace _internal
+
+  /**
+   * Region of snapshot.
+   */
+  struct snapshot_region_t {
+    std::uint64_t start, end;
+    /**
+     * Index of the region's first page in the page table.
+     */
+    std::uint64_t first_page;
+    std::uint32_t path_offset, path_size;
+    /**
+     * region_permissions_t bits.
+     */
+    std::uint8_t permissions;
+    std::uint8_t reserved[ 7 ];
+  };
+
+  /**
+   * Page of snapshot region.
+   */
+  struct snapshot_page_t {
+    constexpr static std::uint64_t unreadable = UINT64_MAX;
+
+    /**
+     * Index of the page data or unreadable if page could not be read.
+     */
+    std::uint64_t data;
+    std::uint64_t hash;
+  };
+
+  /**
+   * Range of memory that differs between snapshots.
+   */
+  struct snapshot_change_t {
+    std::uintptr_t address;
+    std::size_t    size;
+  };
+
+  /**
+   * Snapshot written by process_t::write_snapshot, memory mapped for zero copy access.
+   */
+  class snapshot_t {
+  private:
+    const std::uint8_t * m_data = nullptr;
+    std::size_t          m_size = 0;
+
+    [[nodiscard]] const _internal::snapshot_header_t & header( ) const noexcept {
+      return *reinterpret_cast<const _internal::snapshot_header_t *>( m_data );
+    }
+
+    [[nodiscard]] bool validate( ) const noexcept {
+      if ( m_size < sizeof( _internal::snapshot_header_t ) )
+        return false;
+
+      const auto & file = header( );
+      if ( std::memcmp( file.magic, _internal::snapshot_magic, sizeof( file.magic ) ) != 0 ||
+           file.version != _internal::snapshot_version || file.page_size == 0 )
+        return false;
+
+      // Whether count items of size fit between offset and limit, without overflowing.
+      const auto fits =
+          []( std::uint64_t offset, std::uint64_t count, std::uint64_t size, std::uint64_t limit ) noexcept {
+            return offset <= limit && count <= ( limit - offset ) / size;
+          };
+
+      if ( file.regions_offset % alignof( snapshot_region_t ) != 0 ||
+           file.pages_offset % alignof( snapshot_page_t ) != 0 || file.paths_offset > file.pages_offset ||
+           !fits( file.regions_offset, file.region_count, sizeof( snapshot_region_t ), file.paths_offset ) ||
+           !fits( file.pages_offset, file.page_count, sizeof( snapshot_page_t ), file.data_offset ) ||
+           !fits( file.data_offset, file.data_page_count, file.page_size, m_size ) )
+        return false;
+
+      // Regions must be sorted and disjoint for find_page, and reference only pages and paths of the file.
+      const auto    paths_size = file.pages_offset - file.paths_offset;
+      std::uint64_t previous   = 0;
+      for ( std::size_t i = 0; i < file.region_count; i++ ) {
+        const auto & region = regions( )[ i ];
+        if ( region.end <= region.start || region.start < previous ||
+             !fits( region.first_page, ( region.end - region.start ) / file.page_size, 1, file.page_count ) ||
+             !fits( region.path_offset, region.path_size, 1, paths_size ) )
+          return false;
+        previous = region.end;
+      }
+
+      const auto pages = reinterpret_cast<const snapshot_page_t *>( m_data + file.pages_offset );
+      return std::all_of( pages, pages + file.page_count, [ & ]( const snapshot_page_t & page ) {
+        return page.data == snapshot_page_t::unreadable || page.data < file.data_page_count;
+      } );
+    }
+
+  public:
+    snapshot_t( )                                = default;
+    snapshot_t( const snapshot_t & )             = delete;
+    snapshot_t & operator=( const snapshot_t & ) = delete;
+
+    ~snapshot_t( ) { close( ); }
+
+    /**
+     * Open snapshot file.
+     * @param path path of the snapshot.
+     * @return true if the file is a valid snapshot, false otherwise.
+     */
+    bool open( const std::filesystem::path & path ) {
+      close( );
+
+      const int fd = ::open( path.c_str( ), O_RDONLY | O_CLOEXEC );
+      if ( fd < 0 )
+        return false;
+
+      const auto size    = lseek( fd, 0, SEEK_END );
+      const auto mapping = size > 0 ? mmap( nullptr, size, PROT_READ, MAP_SHARED, fd, 0 ) : MAP_FAILED;
+      ::close( fd );
+      if ( mapping == MAP_FAILED )
+        return false;
+
+      m_data = static_cast<const std::uint8_t *>( mapping );
+      m_size = static_cast<std::size_t>( size );
+      if ( validate( ) )
+        return true;
+
+#ifdef TRICKSTER_DEBUG
+      _internal::log<_internal::log_levels_t::error>( tr_string( "%s is not a valid snapshot." ),
+                                                      path.c_str( ) );
+#endif
+      close( );
+      return false;
+    }
+
+    /**
+     * Unmap snapshot.
+     */
+    void close( ) {
+      if ( m_data )
+        munmap( const_cast<std::uint8_t *>( m_data ), m_size );
+      m_data = nullptr;
+      m_size = 0;
+    }
+
+    [[nodiscard]] bool is_open( ) const noexcept { return m_data != nullptr; }
+    [[nodiscard]] int get_id( ) const noexcept { return header( ).pid; }
+    [[nodiscard]] std::size_t page_size( ) const noexcept { return header( ).page_size; }
+    [[nodiscard]] std::uint64_t timestamp( ) const noexcept { return header( ).timestamp; }
+
+    /**
+     * Get regions sorted by start address.
+     * @return pointer to region_count() regions.
+     */
+    [[nodiscard]] const snapshot_region_t * regions( ) const noexcept {
+      return reinterpret_cast<const snapshot_region_t *>( m_data + header( ).regions_offset );
+    }
+
+    [[nodiscard]] std::size_t region_count( ) const noexcept { return header( ).region_count; }
+
+    /**
+     * Get path of region.
+     * @param region region of this snapshot.
+     * @return path, empty for anonymous regions.
+     */
+    [[nodiscard]] std::string_view path( const snapshot_region_t & region ) const noexcept {
+      return { reinterpret_cast<const char *>( m_data + header( ).paths_offset + region.path_offset ),
+               region.path_size };
+    }
+
+    /**
+     * Get pages of region.
+     * @param region region of this snapshot.
+     * @return pointer to ( end - start ) / page_size() pages.
+     */
+    [[nodiscard]] const snapshot_page_t * pages( const snapshot_region_t & region ) const noexcept {
+      return reinterpret_cast<const snapshot_page_t *>( m_data + header( ).pages_offset ) + region.first_page;
+    }
+
+    /**
+     * Get contents of page.
+     * @param page page of this snapshot.
+     * @return pointer to page_size() bytes or nullptr if page was not readable.
+     */
+    [[nodiscard]] const std::uint8_t * data( const snapshot_page_t & page ) const noexcept {
+      if ( page.data == snapshot_page_t::unreadable )
+        return nullptr;
+      return m_data + header( ).data_offset + page.data * header( ).page_size;
+    }
+
+    /**
+     * Find page containing address.
+     * @param address address to look up.
+     * @return pointer to the page or nullptr if address was not mapped.
+     */
+    [[nodiscard]] const snapshot_page_t * find_page( std::uintptr_t address ) const noexcept {
+      const auto first = regions( ), last = regions( ) + region_count( );
+      const auto upper = std::upper_bound(
+          first, last, address, []( std::uintptr_t value, const snapshot_region_t & region ) {
+            return value < region.start;
+          } );
+      if ( upper == first || address >= upper[ -1 ].end )
+        return nullptr;
+      return pages( upper[ -1 ] ) + ( address - upper[ -1 ].start ) / page_size( );
+    }
+
+    /**
+     * Get snapshot contents at address, without copying.
+     * @param address address to look up.
+     * @return pointer to the byte at address, valid up to the end of its page,
+     * or nullptr if address was not mapped or readable.
+     */
+    [[nodiscard]] const std::uint8_t * at( std::uintptr_t address ) const noexcept {
+      const auto page     = find_page( address );
+      const auto contents = page ? data( *page ) : nullptr;
+      return contents ? contents + address % page_size( ) : nullptr;
+    }
+  };
+
+  namespace utils {
+    /**
+     * Compare two snapshots page by page. Pages with different hashes differ,
+     * pages with equal hashes are compared byte by byte.
+     * @param before older snapshot.
+     * @param after newer snapshot, taken with the same page size.
+     * @return ranges of after that differ from before or were not mapped or
+     * readable in it, sorted and with adjacent pages merged.
+     */
+    [[nodiscard]] inline std::vector<snapshot_change_t> diff_snapshots( const snapshot_t & before,
+                                                                        const snapshot_t & after ) {
+      tr_assert( before.page_size( ) == after.page_size( ), tr_string( "Snapshot page sizes differ." ) );
+
+      std::vector<snapshot_change_t> changes;
+      const auto                     page_size = after.page_size( );
+
+      for ( std::size_t i = 0; i < after.region_count( ); i++ ) {
+        const auto & region = after.regions( )[ i ];
+        const auto   pages  = after.pages( region );
+
+        for ( std::size_t page = 0; page < ( region.end - region.start ) / page_size; page++ ) {
+          const auto address  = region.start + page * page_size;
+          const auto current  = after.data( pages[ page ] );
+          const auto previous = before.find_page( address );
+
+          bool changed;
+          if ( !previous || !before.data( *previous ) || !current )
+            changed = current != nullptr || ( previous && before.data( *previous ) );
+          else
+            changed = previous->hash != pages[ page ].hash ||
+                      std::memcmp( before.data( *previous ), current, page_size ) != 0;
+          if ( !changed )
+            continue;
+
+          if ( !changes.empty( ) && changes.back( ).address + changes.back( ).size == address )
+            changes.back( ).size += page_size;
+          else
+            changes.push_back( { address, page_size } );
+        }
+      }
+      return changes;
+    }
+  } // namespace utils
+
+  /**
+   * Symbol of ELF image.
+   */
+  struct elf_symbol_t {
+    /**
+     * Address relative to the image load bias and size of the symbol.
+     */
+    std::uint64_t value, size;
+    /**
+     * STT_* type and STB_* binding.
+     */
+    std::uint8_t type, binding;
+  };
+
+  /**
+   * Memory mapped 64 bit ELF image with symbol lookup. .dynsym is looked up
+   * through the GNU hash table when present, .symtab (and .dynsym without GNU
+   * hash) through a hash map built when the image is opened. Only defined
+   * symbols are found.
+   */
+  class elf_image_t {
+  private:
+    const std::uint8_t * m_data = nullptr;
+    std::size_t          m_size = 0;
+
+    const Elf64_Sym *     m_dynsym        = nullptr;
+    std::size_t           m_dynsym_count  = 0;
+    const char *          m_dynstr        = nullptr;
+    std::size_t           m_dynstr_size   = 0;
+    const std::uint32_t * m_gnu_hash      = nullptr;
+    std::size_t           m_gnu_hash_size = 0;
+
+    std::unordered_map<std::string_view, const Elf64_Sym *> m_symbols;
+    std::uint64_t                                           m_first_load = 0;
+
+    template <typename T>
+    [[nodiscard]] const T * at( std::uint64_t offset, std::uint64_t count = 1 ) const noexcept {
+      if ( offset > m_size || count > ( m_size - offset ) / sizeof( T ) )
+        return nullptr;
+      return reinterpret_cast<const T *>( m_data + offset );
+    }
+
+    [[nodiscard]] static std::string_view
+    name_of( const Elf64_Sym & symbol, const char * strings, std::size_t size ) noexcept {
+      if ( symbol.st_name >= size )
+        return { };
+      const auto name = strings + symbol.st_name;
+      return { name, strnlen( name, size - symbol.st_name ) };
+    }
+
+    [[nodiscard]] static elf_symbol_t to_symbol( const Elf64_Sym & symbol ) noexcept {
+      return { symbol.st_value,
+               symbol.st_size,
+               static_cast<std::uint8_t>( ELF64_ST_TYPE( symbol.st_info ) ),
+               static_cast<std::uint8_t>( ELF64_ST_BIND( symbol.st_info ) ) };
+    }
+
+    void index( const Elf64_Sym * symbols, std::size_t count, const char * strings, std::size_t size ) {
+      m_symbols.reserve( m_symbols.size( ) + count );
+      for ( std::size_t i = 1; i < count; i++ ) {
+        if ( symbols[ i ].st_shndx == SHN_UNDEF )
+          continue;
+        if ( const auto name = name_of( symbols[ i ], strings, size ); !name.empty( ) )
+          m_symbols.emplace( name, &symbols[ i ] );
+      }
+    }
+
+    [[nodiscard]] const Elf64_Sym * find_gnu_hash( std::string_view name ) const noexcept {
+      const auto words = m_gnu_hash_size / sizeof( std::uint32_t );
+      if ( words < 4 )
+        return nullptr;
+
+      const auto buckets_count = m_gnu_hash[ 0 ], symbol_offset = m_gnu_hash[ 1 ];
+      const auto bloom_size = m_gnu_hash[ 2 ], bloom_shift = m_gnu_hash[ 3 ];
+      if ( buckets_count == 0 || bloom_size == 0 || 4 + bloom_size * 2 + buckets_count > words )
+        return nullptr;
+
+      const auto bloom   = reinterpret_cast<const std::uint64_t *>( m_gnu_hash + 4 );
+      const auto buckets = m_gnu_hash + 4 + bloom_size * 2;
+      const auto chain   = buckets + buckets_count;
+
+      std::uint32_t hash = 5381;
+      for ( const auto character : name )
+        hash = hash * 33 + static_cast<std::uint8_t>( character );
+
+      const auto word = bloom[ ( hash / 64 ) % bloom_size ];
+      const auto mask = ( std::uint64_t { 1 } << ( hash % 64 ) ) |
+                        ( std::uint64_t { 1 } << ( ( hash >> bloom_shift ) % 64 ) );
+      if ( ( word & mask ) != mask )
+        return nullptr;
+
+      auto symbol = buckets[ hash % buckets_count ];
+      for ( ; symbol >= symbol_offset && symbol < m_dynsym_count; symbol++ ) {
+        const auto chain_index = 4 + bloom_size * 2 + buckets_count + ( symbol - symbol_offset );
+        if ( chain_index >= words )
+          return nullptr;
+
+        const auto chain_hash = chain[ symbol - symbol_offset ];
+        if ( ( chain_hash | 1 ) == ( hash | 1 ) && m_dynsym[ symbol ].st_shndx != SHN_UNDEF &&
+             name_of( m_dynsym[ symbol ], m_dynstr, m_dynstr_size ) == name )
+          return &m_dynsym[ symbol ];
+        if ( chain_hash & 1 )
+          return nullptr;
+      }
+      return nullptr;
+    }
+
+    bool parse( ) {
+      const auto header = at<Elf64_Ehdr>( 0 );
+      if ( !header || std::memcmp( header->e_ident, ELFMAG, SELFMAG ) != 0 ||
+           header->e_ident[ EI_CLASS ] != ELFCLASS64 || header->e_ident[ EI_DATA ] != ELFDATA2LSB )
+        return false;
+
+      const auto programs = at<Elf64_Phdr>( header->e_phoff, header->e_phnum );
+      if ( !programs )
+        return false;
+      for ( std::size_t i = 0; i < header->e_phnum; i++ ) {
+        if ( programs[ i ].p_type == PT_LOAD ) {
+          m_first_load = programs[ i ].p_vaddr & ~std::uint64_t { 0xFFF };
+          break;
+        }
+      }
+
+      const auto sections = at<Elf64_Shdr>( header->e_shoff, header->e_shnum );
+      if ( !sections )
+        return false;
+
+      for ( std::size_t i = 0; i < header->e_shnum; i++ ) {
+        const auto & section = sections[ i ];
+        if ( section.sh_type != SHT_SYMTAB && section.sh_type != SHT_DYNSYM &&
+             section.sh_type != SHT_GNU_HASH )
+          continue;
+        if ( section.sh_link >= header->e_shnum )
+          continue;
+
+        if ( section.sh_type == SHT_GNU_HASH ) {
+          m_gnu_hash      = at<std::uint32_t>( section.sh_offset, section.sh_size / sizeof( std::uint32_t ) );
+          m_gnu_hash_size = m_gnu_hash ? section.sh_size : 0;
+          continue;
+        }
+
+        const auto & string_section = sections[ section.sh_link ];
+        const auto   count          = section.sh_size / sizeof( Elf64_Sym );
+        const auto   symbols        = at<Elf64_Sym>( section.sh_offset, count );
+        const auto   strings        = at<char>( string_section.sh_offset, string_section.sh_size );
+        if ( !symbols || !strings )
+          continue;
+
+        if ( section.sh_type == SHT_DYNSYM ) {
+          m_dynsym       = symbols;
+          m_dynsym_count = count;
+          m_dynstr       = strings;
+          m_dynstr_size  = string_section.sh_size;
+        } else {
+          index( symbols, count, strings, string_section.sh_size );
+        }
+      }
+
+      if ( m_dynsym && !m_gnu_hash )
+        index( m_dynsym, m_dynsym_count, m_dynstr, m_dynstr_size );
+      return true;
+    }
+
+  public:
+    elf_image_t( )                                 = default;
+    elf_image_t( const elf_image_t & )             = delete;
+    elf_image_t & operator=( const elf_image_t & ) = delete;
+
+    ~elf_image_t( ) {
+      if ( m_data )
+        munmap( const_cast<std::uint8_t *>( m_data ), m_size );
+    }
+
+    /**
+     * Map and parse ELF image.
+     * @param fd file descriptor of the image, can be closed afterwards.
+     * @return true if image is a valid 64 bit little endian ELF, false otherwise.
+     */
+    bool open( int fd ) {
+      struct stat status;
+      if ( fstat( fd, &status ) != 0 || status.st_size <= 0 )
+        return false;
+
+      const auto size    = static_cast<std::size_t>( status.st_size );
+      const auto mapping = mmap( nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0 );
+      if ( mapping == MAP_FAILED )
+        return false;
+
+      m_data = static_cast<const std::uint8_t *>( mapping );
+      m_size = size;
+      return parse( );
+    }
+
+    /**
+     * Find defined symbol by name.
+     * @param name symbol name.
+     * @return symbol or std::nullopt if it is not defined by the image.
+     */
+    [[nodiscard]] std::optional<elf_symbol_t> find( std::string_view name ) const {
+      if ( m_gnu_hash && m_dynsym ) {
+        if ( const auto symbol = find_gnu_hash( name ) )
+          return to_symbol( *symbol );
+      }
+      const auto symbol = m_symbols.find( name );
+      if ( symbol == m_symbols.end( ) )
+        return std::nullopt;
+      return to_symbol( *symbol->second );
+    }
+
+    /**
+     * Get page aligned virtual address of the first loadable segment, load
+     * bias of the image is address it is mapped at minus this value.
+     * @return virtual address of the first PT_LOAD segment.
+     */
+    [[nodiscard]] std::uint64_t first_load( ) const noexcept { return m_first_load; }
+  };
+
+  namespace _internal {
+    struct elf_key_t {
+      std::uint64_t inode;
+      int           device_major, device_minor;
+
+      [[nodiscard]] bool operator==( const elf_key_t & other ) const noexcept {
+        return inode == other.inode && device_major == other.device_major &&
+               device_minor == other.device_minor;
+      }
+    };
+
+    struct elf_key_hash_t {
+      [[nodiscard]] std::size_t operator( )( const elf_key_t & key ) const noexcept {
+        const auto device = static_cast<std::uint64_t>( key.device_major ) << 20 | key.device_minor;
+        return std::hash<std::uint64_t> { }( key.inode * 0x9E3779B97F4A7C15 ^ device );
+      }
+    };
+
+    /**
+     * Parsed images shared by all process_t objects, keyed by device and inode
+     * of the mapped file. Image is parsed outside of the lock by the first
+     * caller, others wait for its future. Images that could not be opened are
+     * removed so that later lookups try again.
+     */
+    struct elf_cache_t {
+      using image_t  = std::shared_ptr<const elf_image_t>;
+      using images_t = std::unordered_map<elf_key_t, std::shared_future<image_t>, elf_key_hash_t>;
+
+      std::mutex mutex;
+      images_t   images;
+    };
+
+    [[nodiscard]] inline elf_cache_t & elf_cache( ) {
+      static elf_cache_t cache;
+      return cache;
+    }
+
+    /**
+     * Open ELF image mapped by module.
+     * @param pid id of the process mapping the module.
+     * @param module module of the process.
+     * @return image or nullptr, see process_t::get_elf_image.
+     */
+    [[nodiscard]] inline elf_cache_t::image_t open_elf_image( int pid, const module_t & module ) {
+      char root[ 32 ];
+      snprintf( root, sizeof( root ), tr_string( "/proc/%i/root" ), pid );
+
+      std::shared_ptr<const elf_image_t> image;
+      for ( const auto & path : { std::string( module.path ), root + std::string( module.path ) } ) {
+        const int fd = open( path.c_str( ), O_RDONLY | O_CLOEXEC );
+        if ( fd < 0 )
+          continue;
+
+        struct stat status;
+        auto        candidate = std::make_shared<elf_image_t>( );
+        const bool  parsed    = fstat( fd, &status ) == 0 && status.st_ino == module.inode &&
+                            candidate->open( fd );
+        close( fd );
+        if ( parsed ) {
+          image = std::move( candidate );
+          break;
+        }
+      }
+
+#ifdef TRICKSTER_DEBUG
+      if ( !image ) {
+        _internal::log<_internal::log_levels_t::error>( tr_string( "Could not open ELF image of %.*s." ),
+                                                        static_cast<int>( module.path.size( ) ),
+                                                        module.path.data( ) );
+      }
+#endif
+      return image;
+    }
+  } // namespace _internal
+
+  /**
+   * Kind of x86-64 instruction referencing an address.
+   */
+  enum class reference_kind_t : std::uint8_t {
+    call = 0,         // E8 rel32
+    jump,             // E9 rel32
+    conditional_jump, // 0F 80-8F rel32
+    lea,              // lea with RIP-relative operand
+    mov,              // mov with RIP-relative operand
+    memory            // other RIP-relative operand, e.g. call [rip + x] or vmovups
+  };
+
+  /**
+   * Reference of an instruction at site to target address.
+   */
+  struct reference_t {
+    std::uint64_t    target, site;
+    reference_kind_t kind;
+
+    [[nodiscard]] bool operator<( const reference_t & other ) const noexcept {
+      return target != other.target ? target < other.target : site < other.site;
+    }
+  };
+
+  namespace _internal {
+    // Operand flags of opcodes in 64 bit mode.
+    constexpr std::uint8_t x86_modrm = 1 << 0, x86_imm8 = 1 << 1, x86_imm16 = 1 << 2, x86_immz = 1 << 3,
+                           x86_rel8 = 1 << 4, x86_rel32 = 1 << 5, x86_invalid = 1 << 6, x86_prefix = 1 << 7;
+
+    constexpr std::array<std::uint8_t, 256> x86_one_byte_flags( ) {
+      std::array<std::uint8_t, 256> flags { };
+      // add, or, adc, sbb, and, sub, xor, cmp rows.
+      for ( std::size_t row = 0; row < 0x40; row += 8 ) {
+        flags[ row ] = flags[ row + 1 ] = flags[ row + 2 ] = flags[ row + 3 ] = x86_modrm;
+        flags[ row + 4 ]                                                      = x86_imm8;
+        flags[ row + 5 ]                                                      = x86_immz;
+        flags[ row + 6 ] = flags[ row + 7 ] = x86_invalid;
+      }
+      flags[ 0x0F ] = 0;
+      flags[ 0x26 ] = flags[ 0x2E ] = flags[ 0x36 ] = flags[ 0x3E ] = x86_prefix;
+      for ( std::size_t opcode = 0x40; opcode < 0x50; opcode++ )
+        flags[ opcode ] = x86_invalid; // REX not directly before opcode
+      flags[ 0x60 ] = flags[ 0x61 ] = flags[ 0x62 ] = x86_invalid;
+      flags[ 0x63 ]                                 = x86_modrm;
+      flags[ 0x64 ] = flags[ 0x65 ] = flags[ 0x66 ] = flags[ 0x67 ] = x86_prefix;
+      flags[ 0x68 ]                                                 = x86_immz;
+      flags[ 0x69 ]                                                 = x86_modrm | x86_immz;
+      flags[ 0x6A ]                                                 = x86_imm8;
+      flags[ 0x6B ]                                                 = x86_modrm | x86_imm8;
+      for ( std::size_t opcode = 0x70; opcode < 0x80; opcode++ )
+        flags[ opcode ] = x86_rel8;
+      flags[ 0x80 ] = flags[ 0x83 ] = x86_modrm | x86_imm8;
+      flags[ 0x81 ]                 = x86_modrm | x86_immz;
+      flags[ 0x82 ]                 = x86_invalid;
+      for ( std::size_t opcode = 0x84; opcode < 0x90; opcode++ )
+        flags[ opcode ] = x86_modrm;
+      flags[ 0x9A ] = x86_invalid;
+      flags[ 0xA8 ] = x86_imm8;
+      flags[ 0xA9 ] = x86_immz;
+      for ( std::size_t opcode = 0xB0; opcode < 0xB8; opcode++ )
+        flags[ opcode ] = x86_imm8;
+      for ( std::size_t opcode = 0xB8; opcode < 0xC0; opcode++ )
+        flags[ opcode ] = x86_immz;
+      flags[ 0xC0 ] = flags[ 0xC1 ] = flags[ 0xC6 ] = x86_modrm | x86_imm8;
+      flags[ 0xC2 ] = flags[ 0xCA ] = x86_imm16;
+      flags[ 0xC7 ]                 = x86_modrm | x86_immz;
+      flags[ 0xC8 ]                 = x86_imm16 | x86_imm8;
+      flags[ 0xCD ]                 = x86_imm8;
+      flags[ 0xCE ]                 = x86_invalid;
+      for ( std::size_t opcode = 0xD0; opcode < 0xE0; opcode++ )
+        flags[ opcode ] = x86_modrm;
+      flags[ 0xD4 ] = flags[ 0xD5 ] = flags[ 0xD6 ] = x86_invalid;
+      flags[ 0xD7 ]                                 = 0;
+      flags[ 0xE0 ] = flags[ 0xE1 ] = flags[ 0xE2 ] = flags[ 0xE3 ] = flags[ 0xEB ] = x86_rel8;
+      flags[ 0xE4 ] = flags[ 0xE5 ] = flags[ 0xE6 ] = flags[ 0xE7 ] = x86_imm8;
+      flags[ 0xE8 ] = flags[ 0xE9 ] = x86_rel32;
+      flags[ 0xEA ]                 = x86_invalid;
+      flags[ 0xF0 ] = flags[ 0xF2 ] = flags[ 0xF3 ] = x86_prefix;
+      flags[ 0xF6 ] = flags[ 0xF7 ] = flags[ 0xFE ] = flags[ 0xFF ] = x86_modrm;
+      return flags;
+    }
+
+    constexpr std::array<std::uint8_t, 256> x86_two_byte_flags( ) {
+      std::array<std::uint8_t, 256> flags { };
+      for ( auto & flag : flags )
+        flag = x86_modrm;
+      for ( const std::uint8_t opcode : { 0x05, 0x06, 0x07, 0x08, 0x09, 0x0B, 0x0E, 0x30, 0x31, 0x32, 0x33,
+                                          0x34, 0x35, 0x37, 0x77, 0xA0, 0xA1, 0xA2, 0xA8, 0xA9, 0xAA } )
+        flags[ opcode ] = 0;
+      for ( std::size_t opcode = 0xC8; opcode < 0xD0; opcode++ )
+        flags[ opcode ] = 0;
+      for ( std::size_t opcode = 0x80; opcode < 0x90; opcode++ )
+        flags[ opcode ] = x86_rel32;
+      for ( const std::uint8_t opcode :
+            { 0x0F, 0x70, 0x71, 0x72, 0x73, 0xA4, 0xAC, 0xBA, 0xC2, 0xC4, 0xC5, 0xC6 } )
+        flags[ opcode ] = x86_modrm | x86_imm8;
+      for ( const std::uint8_t opcode :
+            { 0x04, 0x0A, 0x0C, 0x24, 0x25, 0x26, 0x27, 0x36, 0x39, 0x3B, 0x3C, 0x3D, 0x3E, 0x3F } )
+        flags[ opcode ] = x86_invalid;
+      return flags;
+    }
+
+    inline constexpr auto x86_one_byte = x86_one_byte_flags( );
+    inline constexpr auto x86_two_byte = x86_two_byte_flags( );
+
+    /**
+     * Decoded length and reference of x86-64 instruction.
+     */
+    struct x86_instruction_t {
+      /**
+       * Instruction length, 0 if bytes are not a valid or complete instruction.
+       */
+      std::uint8_t length;
+      /**
+       * Offset of rel32 or RIP-relative disp32 in the instruction, 0 if none.
+       */
+      std::uint8_t     reference_offset;
+      reference_kind_t kind;
+    };
+
+    /**
+     * Decode length of x86-64 instruction, in 64 bit mode. Legacy, REX, VEX and
+     * EVEX encoded instructions of all opcode maps are supported, only rel32
+     * branches and RIP-relative operands are recognized as references.
+     * @param code instruction bytes.
+     * @param size number of available bytes.
+     * @return decoded instruction.
+     */
+    inline x86_instruction_t decode_x86_64( const std::uint8_t * code, std::size_t size ) noexcept {
+      const auto  limit        = std::min<std::size_t>( size, 15 );
+      std::size_t position     = 0;
+      bool        operand_size = false, address_size = false, wide = false;
+
+      for ( ; position < limit && x86_one_byte[ code[ position ] ] == x86_prefix; position++ ) {
+        operand_size |= code[ position ] == 0x66;
+        address_size |= code[ position ] == 0x67;
+      }
+      if ( position < limit && ( code[ position ] & 0xF0 ) == 0x40 )
+        wide = code[ position++ ] & 0x08;
+      if ( position >= limit )
+        return { };
+
+      std::uint8_t map = 0, flags;
+      auto         opcode = code[ position++ ];
+      if ( opcode == 0xC4 || opcode == 0xC5 || opcode == 0x62 ) {
+        // VEX and EVEX, the opcode map is selected by the prefix and rel32 branches are not encodable.
+        const std::size_t prefix_size = opcode == 0xC5 ? 1 : opcode == 0xC4 ? 2 : 3;
+        if ( position + prefix_size >= limit )
+          return { };
+        map = opcode == 0xC5 ? 1 : code[ position ] & ( opcode == 0x62 ? 0x07 : 0x1F );
+        position += prefix_size;
+        opcode = code[ position++ ];
+        if ( map == 1 )
+          flags = x86_two_byte[ opcode ] & ( x86_modrm | x86_imm8 | x86_invalid );
+        else if ( map == 2 || ( prefix_size == 3 && ( map == 5 || map == 6 ) ) )
+          flags = x86_modrm;
+        else if ( map == 3 )
+          flags = x86_modrm | x86_imm8;
+        else
+          return { };
+      } else if ( opcode == 0x0F ) {
+        if ( position >= limit )
+          return { };
+        opcode = code[ position++ ];
+        if ( opcode == 0x38 || opcode == 0x3A ) {
+          if ( position >= limit )
+            return { };
+          map    = opcode == 0x38 ? 2 : 3;
+          opcode = code[ position++ ];
+          flags  = map == 2 ? x86_modrm : x86_modrm | x86_imm8;
+        } else {
+          map   = 1;
+          flags = x86_two_byte[ opcode ];
+        }
+      } else {
+        flags = x86_one_byte[ opcode ];
+      }
+      if ( flags & ( x86_invalid | x86_prefix ) )
+        return { };
+
+      std::size_t immediate = 0;
+      if ( flags & x86_imm8 )
+        immediate += 1;
+      if ( flags & x86_imm16 )
+        immediate += 2;
+      if ( flags & x86_immz )
+        immediate += operand_size && !wide ? 2 : 4;
+      if ( flags & x86_rel8 )
+        immediate += 1;
+      if ( flags & x86_rel32 )
+        immediate += 4;
+      if ( map == 0 && opcode >= 0xB8 && opcode <= 0xBF && wide )
+        immediate = 8;
+      if ( map == 0 && opcode >= 0xA0 && opcode <= 0xA3 )
+        immediate = address_size ? 4 : 8;
+
+      x86_instruction_t instruction { };
+      if ( flags & x86_rel32 ) {
+        instruction.reference_offset = static_cast<std::uint8_t>( position );
+        instruction.kind             = map == 1         ? reference_kind_t::conditional_jump
+                                       : opcode == 0xE8 ? reference_kind_t::call
+                                                        : reference_kind_t::jump;
+      }
+
+      if ( flags & x86_modrm ) {
+        if ( position >= limit )
+          return { };
+        const auto modrm = code[ position++ ];
+        const auto mod = modrm >> 6, reg = ( modrm >> 3 ) & 7, rm = modrm & 7;
+        if ( map == 0 && ( opcode == 0xF6 || opcode == 0xF7 ) && reg < 2 )
+          immediate += opcode == 0xF6 ? 1 : operand_size && !wide ? 2 : 4;
+
+        if ( mod != 3 && rm == 4 ) {
+          if ( position >= limit )
+            return { };
+          if ( mod == 0 && ( code[ position ] & 7 ) == 5 )
+            immediate += 4;
+          position++;
+        }
+        if ( mod == 1 ) {
+          position += 1;
+        } else if ( mod == 2 ) {
+          position += 4;
+        } else if ( mod == 0 && rm == 5 ) {
+          instruction.reference_offset = static_cast<std::uint8_t>( position );
+          instruction.kind             = reference_kind_t::memory;
+          if ( map == 0 && opcode == 0x8D )
+            instruction.kind = reference_kind_t::lea;
+          else if ( map == 0 && ( ( opcode >= 0x88 && opcode <= 0x8B ) || opcode == 0xC6 || opcode == 0xC7 ) )
+            instruction.kind = reference_kind_t::mov;
+          position += 4;
+        }
+      }
+
+      position += immediate;
+      if ( position > limit )
+        return { };
+      instruction.length = static_cast<std::uint8_t>( position );
+      return instruction;
+    }
+
+    /**
+     * Get reference of decoded instruction.
+     * @param instruction decoded instruction.
+     * @param code instruction bytes.
+     * @param site address of the instruction.
+     * @return reference or std::nullopt if instruction references nothing.
+     */
+    inline std::optional<reference_t> reference_of( const x86_instruction_t & instruction,
+                                                    const std::uint8_t *      code,
+                                                    std::uint64_t             site ) noexcept {
+      if ( instruction.length == 0 || instruction.reference_offset == 0 )
+        return std::nullopt;
+      std::int32_t displacement;
+      std::memcpy( &displacement, code + instruction.reference_offset, sizeof( displacement ) );
+      return reference_t { site + instruction.length + static_cast<std::int64_t>( displacement ),
+                           site,
+                           instruction.kind };
+    }
+  } // namespace _internal
+
+  class process_t;
+
+  /**
+   * Accumulates pending writes that are submitted together using process_t::write_batch.
+   * Adjacent and overlapping writes are coalesced into contiguous runs before
+   * submission, if writes overlap, the one added later wins.
+   * Coalesced runs are cached until batch is modified, so submitting the same
+   * batch repeatedly (e.g. every frame) costs only the syscalls.
+   */
+  class write_batch_t {
+    friend class process_t;
+
+  private:
+    struct pending_t {
+      std::uintptr_t address;
+      std::size_t    size;
+      std::size_t    data_offset;
+    };
+
+    struct run_t {
+      std::uintptr_t address;
+      std::size_t    size;
+      std::size_t    data_offset;
+    };
+
+    std::vector<pending_t>     m_pending;
+    std::vector<std::uint8_t>  m_data;
+    mutable std::vector<run_t> m_runs;
+    // run index of each pending write
+    mutable std::vector<std::size_t>  m_pending_runs;
+    mutable std::vector<std::uint8_t> m_run_data;
+    mutable bool                      m_coalesced = false;
+
+    /**
+     * Build contiguous runs out of pending writes.
+     */
+    void coalesce( ) const {
+      if ( m_coalesced )
+        return;
+
+      std::vector<std::size_t> order( m_pending.size( ) );
+      for ( std::size_t i = 0; i < order.size( ); i++ )
+        order[ i ] = i;
+      std::stable_sort( order.begin( ), order.end( ), [ this ]( std::size_t lhs, std::size_t rhs ) {
+        return m_pending[ lhs ].address < m_pending[ rhs ].address;
+      } );
+
+      m_runs.clear( );
+      m_run_data.clear( );
+      m_pending_runs.resize( m_pending.size( ) );
+
+      for ( std::size_t first = 0; first < order.size( ); ) {
+        const auto  start = m_pending[ order[ first ] ].address;
+        auto        end   = start + m_pending[ order[ first ] ].size;
+        std::size_t last  = first + 1;
+        for ( ; last < order.size( ) && m_pending[ order[ last ] ].address <= end; last++ )
+          end = std::max( end, m_pending[ order[ last ] ].address + m_pending[ order[ last ] ].size );
+
+        const run_t run { start, end - start, m_run_data.size( ) };
+        m_run_data.resize( m_run_data.size( ) + run.size );
+
+        // Copy in insertion order, so later writes overwrite earlier ones.
+        std::sort( order.begin( ) + first, order.begin( ) + last );
+        for ( std::size_t i = first; i < last; i++ ) {
+          const auto & pending = m_pending[ order[ i ] ];
+          std::memcpy( m_run_data.data( ) + run.data_offset + ( pending.address - start ),
+                       m_data.data( ) + pending.data_offset,
+                       pending.size );
+          m_pending_runs[ order[ i ] ] = m_runs.size( );
+        }
+
+        m_runs.push_back( run );
+        first = last;
+      }
+
+      m_coalesced = true;
+    }
+
+  public:
+    /**
+     * Add write of value to the batch.
+     * @param address starting address
+     * @param data data to be written
+     * @param size write size (default: sizeof(T))
+     */
+    template <typename T> void add( std::uintptr_t address, const T & data, std::size_t size = sizeof( T ) ) {
+      static_assert( std::is_trivially_copyable_v<T>, "Batched write requires trivially copyable type." );
+      tr_assert( size <= sizeof( T ), tr_string( "Write size exceeds size of data." ) );
+      add_bytes( address, std::addressof( data ), size );
+    }
+
+    /**
+     * Add write of raw bytes to the batch.
+     * @param address starting address
+     * @param data bytes to be written, copied into the batch
+     * @param size number of bytes
+     */
+    void add_bytes( std::uintptr_t address, const void * data, std::size_t size ) {
+      m_pending.push_back( { address, size, m_data.size( ) } );
+      m_data.insert( m_data.end( ),
+                     static_cast<const std::uint8_t *>( data ),
+                     static_cast<const std::uint8_t *>( data ) + size );
+      m_coalesced = false;
+    }
+
+    /**
+     * Remove all pending writes.
+     */
+    void clear( ) {
+      m_pending.clear( );
+      m_data.clear( );
+      m_coalesced = false;
+    }
+
+    /**
+     * Get number of pending writes.
+     * @return number of writes added since last clear.
+     */
+    [[nodiscard]] std::size_t size( ) const noexcept { return m_pending.size( ); }
+
+    /**
+     * Check if batch has no pending writes.
+     * @return state of statement above.
+     */
+    [[nodiscard]] bool empty( ) const noexcept { return m_pending.empty( ); }
+
+    /**
+     * Get number of contiguous runs pending writes coalesce into.
+     * @return number of remote ranges written on submission.
+     */
+    [[nodiscard]] std::size_t runs( ) const {
+      coalesce( );
+      return m_runs.size( );
+    }
+  };
+
+  class process_t {
+  private:
+    const int                    m_id;
+    const std::string            m_name;
+    const int                    m_mem_fd;
+    const io_backend_t           m_backend;
+    std::vector<memory_region_t> m_regions;
+    std::string                  m_maps_buffer;
+    std::vector<memory_region_t> m_previous_regions;
+    region_index_t               m_index;
+    module_table_t               m_modules;
+
+    mutable std::unique_ptr<_internal::page_cache_t> m_cache;
+
+    // /proc/$PID/pagemap, opened by first read_resident, processes that never use it hold no extra fd.
+    mutable std::once_flag m_pagemap_once;
+    mutable int            m_pagemap_fd = -1;
+
+    // Serializes ptrace backend transfers, parallel scans call transfer from many threads.
+    mutable std::mutex m_ptrace_mutex;
+
+#ifdef TRICKSTER_METRICS
+    const std::unique_ptr<_internal::metrics_t> m_metrics = std::make_unique<_internal::metrics_t>( );
+#endif
+
+    /**
+     * Transfer entries between local and process memory using selected I/O backend.
+     * See _internal::vm_transfer.
+     */
+    template <bool Write, typename F>
+    [[nodiscard]] std::optional<std::size_t>
+    transfer( const std::size_t count, F && entry_at, std::size_t * transferred ) const {
+      _internal::operation_counters_t * counters = nullptr;
+#ifdef TRICKSTER_METRICS
+      counters = &( *m_metrics )[ Write ? metric_operation_t::write : metric_operation_t::read ];
+      const _internal::metrics_timer_t timer( *counters );
+#endif
+      switch ( m_backend ) {
+        case io_backend_t::proc_mem:
+          return _internal::proc_mem_transfer<Write>( m_mem_fd, count, entry_at, transferred, counters );
+        case io_backend_t::ptrace: {
+          std::lock_guard<std::mutex> lock( m_ptrace_mutex );
+          return _internal::ptrace_transfer<Write>( m_id, count, entry_at, transferred, counters );
+        }
+        default: return _internal::vm_transfer<Write>( m_id, count, entry_at, transferred, counters );
+      }
+    }
+
+    /**
+     * Read /proc/$PID/maps into m_maps_buffer.
+     * @return false if maps cannot be read.
+     */
+    [[nodiscard]] bool read_maps( ) {
+      char path[ 32 ];
+      snprintf( path, sizeof( path ), tr_string( "/proc/%i/maps" ), m_id );
+#ifdef TRICKSTER_METRICS
+      auto &                           counters = ( *m_metrics )[ metric_operation_t::maps ];
+      const _internal::metrics_timer_t timer( counters );
+      if ( !_internal::read_file( path, m_maps_buffer ) ) {
+        counters.failure( errno );
+        return false;
+      }
+      counters.transferred( m_maps_buffer.size( ) );
+      return true;
+#else
+      return _internal::read_file( path, m_maps_buffer );
+#endif
+    }
+
+    /**
+     * Serve read from cache, fetching missing lines in single batched transfer.
+     * @return number of bytes read or std::nullopt if process memory cannot be accessed.
+     */
+    [[nodiscard]] std::optional<std::size_t>
+    read_cached( std::uintptr_t address, void * out, std::size_t size ) const {
+      auto &          cache = *m_cache;
+      std::lock_guard lock( cache.mutex );
+
+      const auto line_size = cache.options( ).line_size;
+      const auto first     = cache.line_of( address );
+      const auto last      = cache.line_of( address + size - 1 );
+      const auto lines     = ( last - first ) / line_size + 1;
+
+      // Lines of this read would evict each other.
+      if ( lines > cache.options( ).capacity ) {
+        std::size_t result = 0;
+        const auto  transferred = transfer<false>(
+            1,
+            [ & ]( std::size_t, iovec & local, iovec & remote ) {
+              local.iov_base  = out;
+              local.iov_len   = size;
+              remote.iov_base = reinterpret_cast<void *>( address );
+              remote.iov_len  = size;
+            },
+            &result );
+        return transferred.has_value( ) ? std::optional<std::size_t> { result } : std::nullopt;
+      }
+
+      auto & slots   = cache.slots;
+      auto & missing = cache.missing;
+      slots.resize( lines );
+      missing.clear( );
+      for ( std::size_t i = 0; i < lines; i++ ) {
+        const auto line_address = first + i * line_size;
+        slots[ i ]              = cache.find( line_address );
+        if ( slots[ i ] == _internal::page_cache_t::npos ) {
+          slots[ i ] = cache.acquire( line_address );
+          missing.push_back( { line_address, cache.data( slots[ i ] ), line_size } );
+        }
+      }
+
+      if ( !missing.empty( ) ) {
+        auto & bytes_read = cache.bytes_read;
+        bytes_read.assign( missing.size( ), 0 );
+        const auto result = transfer<false>(
+            missing.size( ),
+            [ & ]( std::size_t index, iovec & local, iovec & remote ) {
+              local.iov_base  = missing[ index ].buffer;
+              local.iov_len   = line_size;
+              remote.iov_base = reinterpret_cast<void *>( missing[ index ].address );
+              remote.iov_len  = line_size;
+            },
+            bytes_read.data( ) );
+
+        for ( std::size_t i = 0, j = 0; i < lines; i++ )
+          if ( j < missing.size( ) && missing[ j ].address == first + i * line_size )
+            cache.commit( slots[ i ], bytes_read[ j++ ] );
+
+        if ( !result.has_value( ) )
+          return std::nullopt;
+      }
+
+      // Copy contiguous valid prefix of the requested range.
+      std::size_t copied = 0;
+      for ( std::size_t i = 0; i < lines && copied < size; i++ ) {
+        const auto line_address = first + i * line_size;
+        const auto begin        = std::max( address, line_address );
+        const auto end          = std::min( address + size, line_address + cache.valid( slots[ i ] ) );
+        if ( begin >= end )
+          break;
+
+        std::memcpy( static_cast<std::uint8_t *>( out ) + ( begin - address ),
+                     cache.data( slots[ i ] ) + ( begin - line_address ),
+                     end - begin );
+        copied += end - begin;
+        if ( end != line_address + line_size )
+          break;
+      }
+      return copied;
+    }
+
+    process_t( int pid, std::optional<std::string> name, io_backend_t backend )
+        : process_t( name.has_value( ) ? pid : invalid,
+                     std::move( name ).value_or( std::string { } ),
+                     backend ) { }
+
+    process_t( int pid, std::string name, io_backend_t backend )
+        : m_id( pid ),
+          m_name( std::move( name ) ),
+          m_mem_fd( backend == io_backend_t::proc_mem && m_id != invalid ? _internal::open_proc_mem( m_id )
+                                                                          : -1 ),
+          m_backend( backend == io_backend_t::proc_mem && m_mem_fd == -1 ? io_backend_t::vm_readv
+                                                                         : backend ) { }
+
+  public:
+    constexpr static int invalid = -1;
+
+    /**
+     * States of pages in the mask filled by read_resident.
+     */
+    constexpr static std::uint8_t page_skipped = 0, page_read = 1, page_unreadable = 2;
+
+    /**
+     * Attach to process.
+     * @param process_name name of the process.
+     * @param backend mechanism used to access process memory. If proc_mem is
+     * selected and /proc/$PID/mem cannot be opened, vm_readv is used instead.
+     * @param match property of the process compared with the name.
+     */
+    explicit process_t( std::string_view process_name,
+                        io_backend_t     backend = io_backend_t::vm_readv,
+                        process_match_t  match   = process_match_t::comm )
+        : process_t( _internal::get_pid_by_name( process_name, match ).value_or( invalid ),
+                     std::string( process_name ),
+                     backend ) { }
+
+    /**
+     * Attach to process by id, e.g. one of the ids returned by utils::get_process_ids.
+     * @param pid process id.
+     * @param backend mechanism used to access process memory. If proc_mem is
+     * selected and /proc/$PID/mem cannot be opened, vm_readv is used instead.
+     */
+    explicit process_t( int pid, io_backend_t backend = io_backend_t::vm_readv )
+        : process_t( pid, _internal::get_process_name( pid ), backend ) { }
+
+    ~process_t( ) {
+      if ( m_mem_fd != -1 )
+        close( m_mem_fd );
+      if ( m_pagemap_fd != -1 )
+        close( m_pagemap_fd );
+    }
+
+    process_t( const process_t & )             = delete;
+    process_t & operator=( const process_t & ) = delete;
+
+    /**
+     * Check if process is valid.
+     * @return state of statement above.
+     */
+    [[nodiscard]] bool is_valid( ) const { return m_id != invalid; }
+
+    /**
+     * Get process id.
+     * @return process id
+     */
+    [[nodiscard]] int get_id( ) const { return m_id; }
+
+    /**
+     * Get mechanism used to access process memory.
+     * @return I/O backend.
+     */
+    [[nodiscard]] io_backend_t get_io_backend( ) const noexcept { return m_backend; }
+
+    /**
+     * Get counters and latency histograms of memory transfers and maps reads
+     * of this process, pid_lookup holds get_pid_lookup_metrics. Counters stay
+     * zero without TRICKSTER_METRICS.
+     * @return snapshot of metrics.
+     */
+    [[nodiscard]] metrics_snapshot_t get_metrics( ) const {
+      metrics_snapshot_t snapshot;
+#ifdef TRICKSTER_METRICS
+      for ( std::size_t i = 0; i < snapshot.operations.size( ); i++ )
+        snapshot.operations[ i ] = m_metrics->operations[ i ].snapshot( );
+#endif
+      const auto pid_lookup             = static_cast<std::size_t>( metric_operation_t::pid_lookup );
+      snapshot.operations[ pid_lookup ] = get_pid_lookup_metrics( );
+      return snapshot;
+    }
+
+    /**
+     * Zero metrics of this process.
+     */
+    void reset_metrics( ) noexcept {
+#ifdef TRICKSTER_METRICS
+      for ( auto & counters : m_metrics->operations )
+        counters.reset( );
+#endif
+    }
+
+    /**
+     * Get process name.
+     * @return process name.
+     */
+    [[nodiscard]] std::string_view get_name( ) const noexcept {
+      tr_assert( is_valid( ), tr_string( "Process is invalid." ) );
+      return m_name;
+    }
+
+    /**
+     * Get process memory regions.
+     * @return std::vector containing memory regions as its entries, it is good
+     * to check if returned vector is not empty because it means that process
+     * with id provided in function call does not exist.
+     */
+    [[nodiscard]] const std::vector<memory_region_t> & get_memory_regions( ) const noexcept {
+      tr_assert( is_valid( ), tr_string( "Process is invalid." ) );
+      return m_regions;
+    }
+
+    /**
+     * Map memory regions.
+     */
+    void map_memory_regions( ) {
+      tr_assert( is_valid( ), tr_string( "Process is invalid." ) );
+      if ( read_maps( ) ) {
+        m_regions = _internal::parse_memory_regions( m_maps_buffer );
+      } else {
+#ifdef TRICKSTER_DEBUG
+        _internal::log<_internal::log_levels_t::error>(
+            tr_string( "Could not get memory regions of process with %i id." ), m_id );
+#endif
+        m_regions.clear( );
+      }
+      m_index.build( m_regions );
+      m_modules.build( m_regions );
+    }
+
+    /**
+     * Map memory regions into compact structure of arrays snapshot.
+     * Regions of the process object itself are left untouched.
+     * @param snapshot receives the regions, its storage and interned paths are reused.
+     * @return true if regions were mapped, false otherwise.
+     */
+    bool map_memory_regions( region_snapshot_t & snapshot ) {
+      tr_assert( is_valid( ), tr_string( "Process is invalid." ) );
+
+      snapshot.clear( );
+      if ( !read_maps( ) )
+        return false;
+
+      _internal::for_each_maps_entry( m_maps_buffer, [ & ]( const _internal::maps_entry_t & entry ) {
+        snapshot.push_back( entry );
+      } );
+      return true;
+    }
+
+    /**
+     * Map memory regions incrementally. Regions that did not change since the
+     * previous call are reused instead of being allocated again, so steady
+     * state refresh costs parsing of the maps file only.
+     * @return difference between previous and current regions, or
+     * std::nullopt if memory regions cannot be read (regions are left untouched).
+     */
+    std::optional<memory_region_diff_t> refresh_memory_regions( ) {
+      tr_assert( is_valid( ), tr_string( "Process is invalid." ) );
+
+      if ( !read_maps( ) ) {
+#ifdef TRICKSTER_DEBUG
+        _internal::log<_internal::log_levels_t::error>(
+            tr_string( "Could not refresh memory regions of process with %i id." ), m_id );
+#endif
+        return std::nullopt;
+      }
+
+      // Keep both vectors alive, so their capacity is reused by the next refresh.
+      std::swap( m_previous_regions, m_regions );
+      auto diff = _internal::refresh_memory_regions( m_maps_buffer, m_previous_regions, m_regions );
+      m_index.build( m_regions );
+      m_modules.build( m_regions );
+      return diff;
+    }
+
+    /**
+     * Get address to region lookup index of the mapped regions.
+     * @return region index, rebuilt by map_memory_regions and refresh_memory_regions.
+     */
+    [[nodiscard]] const region_index_t & get_region_index( ) const noexcept { return m_index; }
+
+    /**
+     * Get module table of the mapped regions.
+     * @return module table, rebuilt by map_memory_regions and refresh_memory_regions.
+     */
+    [[nodiscard]] const module_table_t & get_module_table( ) const noexcept { return m_modules; }
+
+    /**
+     * Find module by filename or full path in O(1).
+     * @param name filename (e.g. libc.so.6) or full path of the module.
+     * @return pointer to the module or nullptr if no such module is mapped.
+     */
+    [[nodiscard]] const module_t * find_module( std::string_view name ) const {
+      return m_modules.find( name );
+    }
+
+    /**
+     * Get base address of module in O(1).
+     * @param name filename (e.g. libc.so.6) or full path of the module.
+     * @return base address or std::nullopt if no such module is mapped.
+     */
+    [[nodiscard]] std::optional<std::uintptr_t> module_base( std::string_view name ) const {
+      return m_modules.module_base( name );
+    }
+
+    /**
+     * Find mapped region containing address in O(log n).
+     * @param address address to look up.
+     * @return pointer to the region or nullptr if address is not mapped.
+     */
+    [[nodiscard]] const memory_region_t * find_region( std::uintptr_t address ) const noexcept {
+      return m_index.find_region( address );
+    }
+
+    /**
+     * Check if range is mapped readable in O(log n).
+     * @param address starting address.
+     * @param size size of the range.
+     * @return state of statement above.
+     */
+    [[nodiscard]] bool is_readable( std::uintptr_t address, std::size_t size = 1 ) const {
+      return m_index.is_readable( address, size );
+    }
+
+    /**
+     * Get filename of module containing address in O(log n).
+     * @param address address to look up.
+     * @return filename of the mapped file, empty if address is not mapped or region is anonymous.
+     */
+    [[nodiscard]] std::string_view module_of( std::uintptr_t address ) const noexcept {
+      return m_index.module_of( address );
+    }
+
+    /**
+     * Enable cache in front of read_memory. Reads are served from cached lines
+     * fetched in whole, write_memory updates and write_batch invalidates
+     * affected lines. Batched reads and scanners always bypass the cache.
+     * @param options cache options.
+     */
+    void enable_cache( const cache_options_t & options = { } ) {
+      m_cache = std::make_unique<_internal::page_cache_t>( options );
+    }
+
+    /**
+     * Disable read_memory cache and release cached lines.
+     */
+    void disable_cache( ) { m_cache.reset( ); }
+
+    /**
+     * Start new frame, lines cached in the previous frame are fetched again on next access.
+     */
+    void begin_frame( ) const {
+      if ( !m_cache )
+        return;
+      std::lock_guard lock( m_cache->mutex );
+      m_cache->invalidate_all( );
+    }
+
+    /**
+     * Get cache counters.
+     * @return cache counters, all zero if cache is disabled.
+     */
+    [[nodiscard]] cache_stats_t get_cache_stats( ) const {
+      if ( !m_cache )
+        return { };
+      std::lock_guard lock( m_cache->mutex );
+      return m_cache->stats( );
+    }
+
+    /**
+     * Read process memory.
+     * @param address starting address
+     * @param size read size (default: sizeof(T))
+     * @return read_result_t struct. See tr.hpp (line 127)
+     *
+     * NOTE: process_vm_readv return value may be less than the total number
+     * of requested bytes, if a partial write occurred. Define TRICKSTER_DEBUG
+     * to see if this situation (the one described above) happens.
+     *
+     * TODO: return bool (bytes requested == bytes written)
+     */
+
+    // clang-format off
+    template <typename T>
+    std::optional<_internal::read_result_t<T>> 
+    read_memory( std::uintptr_t address, std::size_t size = sizeof( T ) ) const {
+      // clang-format on
+      tr_assert( is_valid( ), tr_string( "Process is invalid." ) );
+
+      tr_assert( size <= sizeof( T ), tr_string( "Read size exceeds size of type." ) );
+
+      T                          buffer {};
+      std::size_t                result = 0;
+      std::optional<std::size_t> transferred;
+
+      if ( m_cache && size != 0 ) {
+        transferred = read_cached( address, std::addressof( buffer ), size );
+        result      = transferred.value_or( 0 );
+      } else {
+        transferred = transfer<false>(
+            1,
+            [ & ]( std::size_t, iovec & local, iovec & remote ) {
+              local.iov_base  = std::addressof( buffer );
+              local.iov_len   = size;
+              remote.iov_base = reinterpret_cast<void *>( address );
+              remote.iov_len  = size;
+            },
+            &result );
+      }
+
+      if ( !transferred.has_value( ) || ( result == 0 && size != 0 ) ) {
+#ifdef TRICKSTER_DEBUG
+        _internal::log<_internal::log_levels_t::error>(
+            tr_string( "Memory reading (at %p) failed with error code: %i, Message: %s" ),
+            address,
+            errno,
+            strerror( errno ) );
+#endif
+        return std::nullopt;
+      }
+#ifdef TRICKSTER_DEBUG
+      if ( result != size ) {
+        _internal::log<_internal::log_levels_t::info>( tr_string( "Partial read occured." ) );
+      }
+#endif
+      return _internal::read_result_t<T> { buffer, size, result };
+    }
+
+    /**
+     * Read many, possibly non-contiguous, memory ranges with as few syscalls as possible.
+     * @param entries ranges to read and buffers to read them into.
+     * @param count number of entries.
+     * @param bytes_read optional array of count elements receiving bytes read
+     * per entry. Entry was read successfully if its value equals entry size,
+     * partially if it is smaller and non zero, and failed if it is zero.
+     * @return number of fully read entries or std::nullopt if process memory
+     * cannot be accessed.
+     */
+    std::optional<std::size_t> read_scatter( const read_entry_t * entries,
+                                             std::size_t          count,
+                                             std::size_t *        bytes_read = nullptr ) const {
+      tr_assert( is_valid( ), tr_string( "Process is invalid." ) );
+
+      return transfer<false>(
+          count,
+          [ entries ]( std::size_t index, iovec & local, iovec & remote ) {
+            local.iov_base  = entries[ index ].buffer;
+            local.iov_len   = entries[ index ].size;
+            remote.iov_base = reinterpret_cast<void *>( entries[ index ].address );
+            remote.iov_len  = entries[ index ].size;
+          },
+          bytes_read );
+    }
+
+    /**
+     * Read values of the same type from many addresses into contiguous storage.
+     * @param addresses addresses to read from.
+     * @param count number of addresses.
+     * @param out array of count elements receiving the values.
+     * @param bytes_read optional per entry bytes read. See read_scatter.
+     * @return number of fully read values or std::nullopt if process memory
+     * cannot be accessed.
+     */
+    template <typename T>
+    std::optional<std::size_t> read_many( const std::uintptr_t * addresses,
+                                          std::size_t            count,
+                                          T *                    out,
+                                          std::size_t *          bytes_read = nullptr ) const {
+      tr_assert( is_valid( ), tr_string( "Process is invalid." ) );
+      static_assert( std::is_trivially_copyable_v<T>, "Batched read requires trivially copyable type." );
+
+      return transfer<false>(
+          count,
+          [ addresses, out ]( std::size_t index, iovec & local, iovec & remote ) {
+            local.iov_base  = std::addressof( out[ index ] );
+            local.iov_len   = sizeof( T );
+            remote.iov_base = reinterpret_cast<void *>( addresses[ index ] );
+            remote.iov_len  = sizeof( T );
+          },
+          bytes_read );
+    }
+
+    /**
+     * Read values of the same type from many addresses.
+     * @param addresses addresses to read from.
+     * @param out receives the values, resized to match addresses.
+     * @param bytes_read optional per entry bytes read, resized to match addresses.
+     * @return number of fully read values or std::nullopt if process memory
+     * cannot be accessed.
+     */
+    template <typename T>
+    std::optional<std::size_t> read_many( const std::vector<std::uintptr_t> & addresses,
+                                          std::vector<T> &                    out,
+                                          std::vector<std::size_t> *          bytes_read = nullptr ) const {
+      out.resize( addresses.size( ) );
+      if ( bytes_read )
+        bytes_read->resize( addresses.size( ) );
+
+      return read_many(
+          addresses.data( ), addresses.size( ), out.data( ), bytes_read ? bytes_read->data( ) : nullptr );
+    }
+
+    /**
+     * Read range skipping pages that are neither present nor swapped out, so
+     * they are not faulted in. Skipped pages are zero filled in the buffer.
+     * In private anonymous memory such pages were never written and really
+     * are zeros, in file backed or shared memory they can hold data that was
+     * not faulted in yet. Without access to /proc/$PID/pagemap every page is
+     * read, it is opened by the first call.
+     * @param address starting address.
+     * @param buffer buffer of size bytes.
+     * @param size size of the range.
+     * @param present optional mask receiving state of every page the range
+     * touches: page_read, page_skipped (not resident, zero filled) or
+     * page_unreadable (resident, but could not be read, zero filled).
+     * @return number of bytes read or std::nullopt if process memory cannot be accessed.
+     */
+    std::optional<std::size_t> read_resident( std::uintptr_t              address,
+                                              void *                      buffer,
+                                              std::size_t                 size,
+                                              std::vector<std::uint8_t> * present = nullptr ) const {
+      tr_assert( is_valid( ), tr_string( "Process is invalid." ) );
+
+      const auto page_size  = static_cast<std::uintptr_t>( sysconf( _SC_PAGESIZE ) );
+      const auto first_page = address / page_size;
+      const auto pages      = size == 0 ? 0 : ( address + size - 1 ) / page_size - first_page + 1;
+      const auto out        = static_cast<std::uint8_t *>( buffer );
+
+      std::call_once( m_pagemap_once, [ this ] { m_pagemap_fd = _internal::open_pagemap( m_id ); } );
+
+      std::vector<std::uint64_t> entries( pages, _internal::pagemap_present );
+      if ( m_pagemap_fd != -1 && pages != 0 ) {
+        const auto bytes = static_cast<ssize_t>( pages * sizeof( std::uint64_t ) );
+        if ( pread( m_pagemap_fd, entries.data( ), bytes, first_page * sizeof( std::uint64_t ) ) != bytes )
+          std::fill( entries.begin( ), entries.end( ), _internal::pagemap_present );
+      }
+
+      const auto resident = [ & ]( std::size_t page ) -> std::uint8_t {
+        return ( entries[ page ] & ( _internal::pagemap_present | _internal::pagemap_swapped ) ) != 0;
+      };
+
+      // Resident pages are read in runs, skipped ones are zeroed in place.
+      std::vector<read_entry_t> runs;
+      for ( std::size_t page = 0; page < pages; page++ ) {
+        const auto begin = std::max( address, ( first_page + page ) * page_size );
+        const auto end   = std::min( address + size, ( first_page + page + 1 ) * page_size );
+        if ( !resident( page ) ) {
+          std::memset( out + ( begin - address ), 0, end - begin );
+          continue;
+        }
+        if ( !runs.empty( ) && runs.back( ).address + runs.back( ).size == begin )
+          runs.back( ).size += end - begin;
+        else
+          runs.push_back( { begin, out + ( begin - address ), end - begin } );
+      }
+
+      if ( present ) {
+        present->resize( pages );
+        for ( std::size_t page = 0; page < pages; page++ )
+          ( *present )[ page ] = resident( page ) ? page_read : page_skipped;
+      }
+
+      // Faulting page of a short run is skipped and the rest of the run is read again.
+      std::size_t               total = 0;
+      std::vector<std::size_t>  bytes_read;
+      std::vector<read_entry_t> retry;
+      while ( !runs.empty( ) ) {
+        bytes_read.assign( runs.size( ), 0 );
+        if ( !read_scatter( runs.data( ), runs.size( ), bytes_read.data( ) ).has_value( ) )
+          return std::nullopt;
+
+        retry.clear( );
+        for ( std::size_t run = 0; run < runs.size( ); run++ ) {
+          total += bytes_read[ run ];
+          if ( bytes_read[ run ] == runs[ run ].size )
+            continue;
+
+          const auto & entry  = runs[ run ];
+          const auto   fault  = entry.address + bytes_read[ run ];
+          const auto   next   = std::min( ( fault / page_size + 1 ) * page_size, entry.address + entry.size );
+          const auto   unread = static_cast<std::uint8_t *>( entry.buffer ) + bytes_read[ run ];
+          std::memset( unread, 0, next - fault );
+          if ( present )
+            ( *present )[ fault / page_size - first_page ] = page_unreadable;
+          if ( next < entry.address + entry.size )
+            retry.push_back( { next, out + ( next - address ), entry.address + entry.size - next } );
+        }
+        runs.swap( retry );
+      }
+      return total;
+    }
+
+    /**
+     * Read chunk of a scanned region and report the parts of the buffer that
+     * hold process memory, so scanners never match bytes that were not read.
+     * Private anonymous chunks are read with read_resident: pages that are not
+     * resident were never written and are reported as zeros, pages that could
+     * not be read are excluded. Other chunks are read up to the first fault.
+     * @param address starting address.
+     * @param buffer buffer of size bytes.
+     * @param size size of the chunk.
+     * @param anonymous true if the chunk is private anonymous memory.
+     * @param scan callable receiving begin and end offset of every valid part, in order.
+     * @return false if process memory cannot be accessed.
+     */
+    template <typename F>
+    bool read_scannable(
+        std::uintptr_t address, std::uint8_t * buffer, std::size_t size, bool anonymous, F && scan ) const {
+      if ( !anonymous ) {
+        std::size_t        bytes_read = 0;
+        const read_entry_t entry { address, buffer, size };
+        if ( !read_scatter( &entry, 1, &bytes_read ).has_value( ) )
+          return false;
+        if ( bytes_read != 0 )
+          scan( std::size_t { 0 }, bytes_read );
+        return true;
+      }
+
+      std::vector<std::uint8_t> pages;
+      if ( !read_resident( address, buffer, size, &pages ).has_value( ) )
+        return false;
+
+      const auto  page_size = static_cast<std::uintptr_t>( sysconf( _SC_PAGESIZE ) );
+      const auto  offset_of = [ & ]( std::size_t page ) {
+        return std::min<std::size_t>( ( address / page_size + page ) * page_size - address, size );
+      };
+      std::size_t begin = 0;
+      for ( std::size_t page = 0; page < pages.size( ); page++ ) {
+        if ( pages[ page ] != page_unreadable )
+          continue;
+        const auto end = page == 0 ? 0 : offset_of( page );
+        if ( end > begin )
+          scan( begin, end );
+        begin = offset_of( page + 1 );
+      }
+      if ( size > begin )
+        scan( begin, size );
+      return true;
+    }
+
+    /**
+     * Read large range, continuing past unmapped and unreadable parts instead of
+     * stopping at the first one. Range is split at region boundaries using the
+     * mapped regions (if any), unreadable regions and gaps are not read at all.
+     * After a fault the faulting page is skipped and the rest is retried, all
+     * pending parts are read together, so every round is one batched transfer.
+     * @param address starting address.
+     * @param buffer buffer of size bytes.
+     * @param size size of the range.
+     * @param sentinel value unreadable bytes are filled with (default: 0).
+     * @return sorted, merged list of ranges that were read, or std::nullopt
+     * if process memory cannot be accessed.
+     */
+    std::optional<std::vector<page_range_t>>
+    read_range( std::uintptr_t address, void * buffer, std::size_t size, std::uint8_t sentinel = 0 ) const {
+      tr_assert( is_valid( ), tr_string( "Process is invalid." ) );
+
+      const auto page_size = static_cast<std::uintptr_t>( sysconf( _SC_PAGESIZE ) );
+      const auto out       = static_cast<std::uint8_t *>( buffer );
+      const auto end       = address + size;
+
+      std::vector<read_entry_t> pending, next;
+      const auto                fill = [ & ]( std::uintptr_t from, std::uintptr_t to ) {
+        std::memset( out + ( from - address ), sentinel, to - from );
+      };
+
+      if ( m_regions.empty( ) ) {
+        pending.push_back( { address, out, size } );
+      } else {
+        auto cursor = address;
+        const auto after = []( std::uintptr_t value, const memory_region_t & entry ) {
+          return value < entry.end;
+        };
+        auto region = std::upper_bound( m_regions.begin( ), m_regions.end( ), address, after );
+        for ( ; region != m_regions.end( ) && region->start < end; region++ ) {
+          const auto begin = std::max<std::uintptr_t>( region->start, address );
+          const auto stop  = std::min<std::uintptr_t>( region->end, end );
+          fill( cursor, begin );
+          if ( region->readable )
+            pending.push_back( { begin, out + ( begin - address ), stop - begin } );
+          else
+            fill( begin, stop );
+          cursor = stop;
+        }
+        fill( cursor, end );
+      }
+
+      std::vector<page_range_t> readable;
+      std::vector<std::size_t>  bytes_read;
+      while ( !pending.empty( ) ) {
+        bytes_read.resize( pending.size( ) );
+        if ( !read_scatter( pending.data( ), pending.size( ), bytes_read.data( ) ).has_value( ) )
+          return std::nullopt;
+
+        next.clear( );
+        for ( std::size_t i = 0; i < pending.size( ); i++ ) {
+          const auto & entry = pending[ i ];
+          const auto   stop  = entry.address + entry.size;
+          if ( bytes_read[ i ] != 0 )
+            readable.push_back( { entry.address, entry.address + bytes_read[ i ] } );
+          if ( bytes_read[ i ] == entry.size )
+            continue;
+
+          // Skip the rest of the faulting page and retry after it.
+          const auto fault  = entry.address + bytes_read[ i ];
+          const auto resume = std::min( ( fault / page_size + 1 ) * page_size, stop );
+          fill( fault, resume );
+          if ( resume < stop )
+            next.push_back( { resume, out + ( resume - address ), stop - resume } );
+        }
+        std::swap( pending, next );
+      }
+
+      std::sort( readable.begin( ), readable.end( ), []( const auto & lhs, const auto & rhs ) {
+        return lhs.start < rhs.start;
+      } );
+      std::vector<page_range_t> merged;
+      for ( const auto & range : readable ) {
+        if ( !merged.empty( ) && merged.back( ).end == range.start )
+          merged.back( ).end = range.end;
+        else
+          merged.push_back( range );
+      }
+      return merged;
+    }
+
+    /**
+     * Resolve many pointer chains at once, level by level. Pointers of all chains
+     * at the same depth are read in one batch, so resolution costs one batched
+     * read per level instead of one syscall per pointer.
+     * @param chains chains to resolve.
+     * @param count number of chains.
+     * @param out array of count elements receiving resolved addresses,
+     * std::nullopt for chains that hit unreadable pointer.
+     * @param share_prefixes read every distinct pointer address of a level once,
+     * chains sharing a prefix read it only once (default: true).
+     * @return number of resolved chains or std::nullopt if process memory
+     * cannot be accessed.
+     */
+    std::optional<std::size_t> resolve_pointer_chains( const pointer_chain_t *         chains,
+                                                       std::size_t                     count,
+                                                       std::optional<std::uintptr_t> * out,
+                                                       bool share_prefixes = true ) const {
+      tr_assert( is_valid( ), tr_string( "Process is invalid." ) );
+
+      std::vector<std::uintptr_t> addresses( count ), reads, pointers;
+      std::vector<std::size_t>    active, next, bytes_read;
+      std::size_t                 resolved = 0;
+
+      for ( std::size_t i = 0; i < count; i++ ) {
+        const auto & offsets = chains[ i ].offsets;
+        addresses[ i ]       = chains[ i ].base + ( offsets.empty( ) ? 0 : offsets.front( ) );
+        out[ i ]             = std::nullopt;
+        if ( offsets.size( ) > 1 ) {
+          active.push_back( i );
+          continue;
+        }
+        out[ i ] = addresses[ i ];
+        resolved++;
+      }
+
+      for ( std::size_t level = 1; !active.empty( ); level++ ) {
+        reads.clear( );
+        for ( const auto chain : active )
+          reads.push_back( addresses[ chain ] );
+        if ( share_prefixes ) {
+          std::sort( reads.begin( ), reads.end( ) );
+          reads.erase( std::unique( reads.begin( ), reads.end( ) ), reads.end( ) );
+        }
+
+        pointers.resize( reads.size( ) );
+        bytes_read.resize( reads.size( ) );
+        if ( !read_many( reads.data( ), reads.size( ), pointers.data( ), bytes_read.data( ) ).has_value( ) )
+          return std::nullopt;
+
+        next.clear( );
+        for ( std::size_t i = 0; i < active.size( ); i++ ) {
+          const auto chain = active[ i ];
+          const auto slot  = share_prefixes
+                                 ? static_cast<std::size_t>(
+                                      std::lower_bound( reads.begin( ), reads.end( ), addresses[ chain ] ) -
+                                      reads.begin( ) )
+                                 : i;
+          if ( bytes_read[ slot ] != sizeof( std::uintptr_t ) )
+            continue;
+
+          const auto & offsets = chains[ chain ].offsets;
+          addresses[ chain ]   = pointers[ slot ] + offsets[ level ];
+          if ( level + 1 < offsets.size( ) ) {
+            next.push_back( chain );
+            continue;
+          }
+          out[ chain ] = addresses[ chain ];
+          resolved++;
+        }
+        std::swap( active, next );
+      }
+      return resolved;
+    }
+
+    /**
+     * Resolve many pointer chains at once. See resolve_pointer_chains above.
+     * @param chains chains to resolve.
+     * @param out receives resolved addresses, resized to match chains.
+     * @param share_prefixes read every distinct pointer address of a level once (default: true).
+     * @return number of resolved chains or std::nullopt if process memory
+     * cannot be accessed.
+     */
+    std::optional<std::size_t> resolve_pointer_chains( const std::vector<pointer_chain_t> &         chains,
+                                                       std::vector<std::optional<std::uintptr_t>> & out,
+                                                       bool share_prefixes = true ) const {
+      out.resize( chains.size( ) );
+      return resolve_pointer_chains( chains.data( ), chains.size( ), out.data( ), share_prefixes );
+    }
+
+    /**
+     * Write process memory.
+     * @param address starting address
+     * @param data data to be written
+     * @param size read size (default: sizeof(T))
+     * @return write_result_t struct. See tr.hpp (line 137)
+     *
+     * NOTE: process_vm_writev return value may be less than the total number
+     * of requested bytes, if a partial write occurred. Define TRICKSTER_DEBUG
+     * to see if this situation (the one described above) happens.
+     */
+    template <typename T>
+    std::optional<_internal::write_result_t<T>>
+    write_memory( std::uintptr_t address, const T & data, std::size_t size = sizeof( T ) ) const {
+      tr_assert( is_valid( ), tr_string( "Process is invalid." ) );
+
+      tr_assert( size <= sizeof( T ), tr_string( "Write size exceeds size of type." ) );
+
+      std::size_t result = 0;
+
+      const auto transferred = transfer<true>(
+          1,
+          [ & ]( std::size_t, iovec & local, iovec & remote ) {
+            local.iov_base  = const_cast<T *>( std::addressof( data ) );
+            local.iov_len   = size;
+            remote.iov_base = reinterpret_cast<void *>( address );
+            remote.iov_len  = size;
+          },
+          &result );
+
+      if ( !transferred.has_value( ) || ( result == 0 && size != 0 ) ) {
+#ifdef TRICKSTER_DEBUG
+        _internal::log<_internal::log_levels_t::error>(
+            tr_string( "Memory writing (at %p) failed with error code: %i, Message: %s" ),
+            address,
+            errno,
+            strerror( errno ) );
+#endif
+        return std::nullopt;
+      }
+#ifdef TRICKSTER_DEBUG
+      if ( result != size ) {
+        _internal::log<_internal::log_levels_t::info>( tr_string( "Partial write occured." ) );
+      }
+#endif
+      if ( m_cache ) {
+        std::lock_guard lock( m_cache->mutex );
+        m_cache->update( address, std::addressof( data ), result );
+      }
+      return _internal::write_result_t<T> { size, result };
+    }
+
+    /**
+     * Write all pending writes of the batch.
+     * Coalesced runs are submitted in iov_max sized process_vm_writev calls.
+     * @param batch batch of pending writes.
+     * @return write_result_t of every pending write in order they were added,
+     * or std::nullopt if process memory cannot be accessed. Write whose bytes
+     * were overwritten by later write in the same batch reports bytes that
+     * reached the process memory.
+     */
+    std::optional<std::vector<_internal::write_result_t<void>>>
+    write_batch( const write_batch_t & batch ) const {
+      tr_assert( is_valid( ), tr_string( "Process is invalid." ) );
+
+      batch.coalesce( );
+
+      std::vector<std::size_t> bytes_written( batch.m_runs.size( ) );
+      const auto               result = transfer<true>(
+          batch.m_runs.size( ),
+          [ &batch ]( std::size_t index, iovec & local, iovec & remote ) {
+            const auto & run = batch.m_runs[ index ];
+            local.iov_base   = const_cast<std::uint8_t *>( batch.m_run_data.data( ) + run.data_offset );
+            local.iov_len    = run.size;
+            remote.iov_base  = reinterpret_cast<void *>( run.address );
+            remote.iov_len   = run.size;
+          },
+          bytes_written.data( ) );
+
+      if ( m_cache ) {
+        std::lock_guard lock( m_cache->mutex );
+        for ( const auto & run : batch.m_runs )
+          m_cache->invalidate( run.address, run.size );
+      }
+
+      if ( !result.has_value( ) )
+        return std::nullopt;
+
+      std::vector<_internal::write_result_t<void>> results;
+      results.reserve( batch.m_pending.size( ) );
+      for ( std::size_t i = 0; i < batch.m_pending.size( ); i++ ) {
+        const auto & pending     = batch.m_pending[ i ];
+        const auto & run         = batch.m_runs[ batch.m_pending_runs[ i ] ];
+        const auto   written_end = run.address + bytes_written[ batch.m_pending_runs[ i ] ];
+        const auto   written =
+            written_end > pending.address ? std::min( written_end - pending.address, pending.size ) : 0;
+        results.push_back( { pending.size, written } );
+      }
+
+#ifdef TRICKSTER_DEBUG
+      if ( *result != batch.m_runs.size( ) ) {
+        _internal::log<_internal::log_levels_t::info>( tr_string( "Partial batched write occured." ) );
+      }
+#endif
+      return results;
+    }
+
+    /**
+     * Find pattern in readable memory regions.
+     * Uses regions from the last map_memory_regions call. Regions are read in
+     * chunks of options.chunk_size, chunks are scanned in parallel.
+     * Matches spanning two regions are not reported.
+     * @param pattern pattern to find.
+     * @param options scan options.
+     * @return sorted addresses of matches.
+     */
+    [[nodiscard]] std::vector<std::uintptr_t> find_pattern( const pattern_t &      pattern,
+                                                            const scan_options_t & options = { } ) const {
+      tr_assert( is_valid( ), tr_string( "Process is invalid." ) );
+      tr_assert( options.chunk_size > 0, tr_string( "Chunk size is 0." ) );
+
+      struct chunk_t {
+        std::uintptr_t start, end, region_end;
+        bool           anonymous;
+      };
+
+      std::vector<chunk_t> chunks;
+      for ( const auto & region : m_regions ) {
+        if ( !region.readable || ( options.executable_only && !region.executable ) )
+          continue;
+        if ( !options.module.empty( ) && region.filename != options.module )
+          continue;
+
+        for ( auto start = region.start; start < region.end; start += options.chunk_size ) {
+          const auto end = std::min<std::uintptr_t>( start + options.chunk_size, region.end );
+          chunks.push_back( { start, end, region.end, _internal::is_private_anonymous( region ) } );
+        }
+      }
+
+      auto &                                   pool = options.pool ? *options.pool : thread_pool_t::shared( );
+      std::vector<std::vector<std::uint8_t>>   buffers( pool.size( ) );
+      std::vector<std::vector<std::uintptr_t>> matches( pool.size( ) );
+
+      // With a limit, once found reaches it, every match counted so far lies in a chunk
+      // not above bound, so chunks above bound cannot hold any of the lowest matches.
+      // Chunks below bound are always scanned, even if they were claimed late.
+      std::atomic<std::size_t> found { 0 }, highest { 0 };
+      std::atomic<std::size_t> bound { std::numeric_limits<std::size_t>::max( ) };
+
+      pool.parallel_for( chunks.size( ), [ & ]( std::size_t index, std::size_t worker ) {
+        if ( index > bound.load( ) )
+          return;
+
+        // Read pattern length - 1 bytes past the chunk to find matches crossing its end.
+        const auto & chunk = chunks[ index ];
+        const auto   size  = std::min<std::uintptr_t>( chunk.end - chunk.start + pattern.size( ) - 1,
+                                                      chunk.region_end - chunk.start );
+        auto &       buffer = buffers[ worker ];
+        buffer.resize( size );
+
+        std::size_t in_chunk = 0;
+        const auto  on_match = [ & ]( std::size_t offset ) {
+          if ( chunk.start + offset >= chunk.end || index > bound.load( ) )
+            return false;
+          // Matches of this chunk past its first limit ones are never among the lowest.
+          if ( options.limit != 0 && in_chunk == options.limit )
+            return false;
+
+          matches[ worker ].push_back( chunk.start + offset );
+          if ( options.limit == 0 )
+            return true;
+
+          auto previous = highest.load( );
+          while ( previous < index && !highest.compare_exchange_weak( previous, index ) )
+            ;
+          if ( found.fetch_add( 1 ) + 1 == options.limit )
+            bound.store( highest.load( ) );
+          in_chunk++;
+          return true;
+        };
+
+        // Untouched anonymous pages are zeros, they are not faulted in just to be scanned.
+        const auto scan = [ & ]( std::size_t begin, std::size_t end ) {
+          const auto shifted = [ & ]( std::size_t offset ) { return on_match( begin + offset ); };
+          _internal::match_pattern( buffer.data( ) + begin, end - begin, pattern, shifted );
+        };
+        (void)read_scannable( chunk.start, buffer.data( ), size, chunk.anonymous, scan );
+      } );
+
+      std::vector<std::uintptr_t> addresses;
+      for ( auto & worker_matches : matches )
+        addresses.insert( addresses.end( ), worker_matches.begin( ), worker_matches.end( ) );
+      std::sort( addresses.begin( ), addresses.end( ) );
+
+      if ( options.limit != 0 && addresses.size( ) > options.limit )
+        addresses.resize( options.limit );
+      return addresses;
+    }
+
+    /**
+     * Find IDA style signature in readable memory regions.
+     * @param signature signature to find, e.g. "48 8B ?? ?? E8".
+     * @param options scan options.
+     * @return sorted addresses of matches, empty if signature is malformed.
+     */
+    [[nodiscard]] std::vector<std::uintptr_t> find_pattern( std::string_view       signature,
+                                                            const scan_options_t & options = { } ) const {
+      const auto pattern = pattern_t::parse( signature );
+      if ( !pattern.has_value( ) ) {
+#ifdef TRICKSTER_DEBUG
+        _internal::log<_internal::log_levels_t::error>( tr_string( "Malformed signature: '%.*s'." ),
+                                                        static_cast<int>( signature.size( ) ),
+                                                        signature.data( ) );
+#endif
+        return { };
+      }
+      return find_pattern( *pattern, options );
+    }
+
+    /**
+     * Write snapshot of all readable regions to file, to be opened with snapshot_t.
+     * Regions are streamed in chunks, unreadable pages are recorded as such.
+     * @param path path of the snapshot file, overwritten if it exists.
+     * @param options snapshot options.
+     * @return true if snapshot was written, false otherwise, also if paths of
+     * the regions do not fit 32 bit offsets.
+     */
+    bool write_snapshot( const std::filesystem::path & path,
+                         const snapshot_options_t &    options = { } ) const {
+      tr_assert( is_valid( ), tr_string( "Process is invalid." ) );
+
+      const auto page_size = static_cast<std::size_t>( sysconf( _SC_PAGESIZE ) );
+      tr_assert( options.chunk_size % page_size == 0,
+                 tr_string( "Chunk size is not a multiple of page size." ) );
+
+      std::vector<snapshot_region_t> table;
+      std::string                    paths;
+      std::uint64_t                  page_count = 0;
+      for ( const auto & region : m_regions ) {
+        if ( !region.readable || ( options.writable_only && !region.writable ) )
+          continue;
+
+        // Region table has 32 bit path offsets and sizes, and a 32 bit region count.
+        if ( paths.size( ) + region.path.native( ).size( ) > UINT32_MAX || table.size( ) == UINT32_MAX ) {
+#ifdef TRICKSTER_DEBUG
+          _internal::log<_internal::log_levels_t::error>(
+              tr_string( "Could not write snapshot %s, region table exceeds 32 bit limits." ),
+              path.c_str( ) );
+#endif
+          return false;
+        }
+
+        snapshot_region_t entry { };
+        entry.start       = region.start;
+        entry.end         = region.end;
+        entry.first_page  = page_count;
+        entry.path_offset = static_cast<std::uint32_t>( paths.size( ) );
+        entry.path_size   = static_cast<std::uint32_t>( region.path.native( ).size( ) );
+        entry.permissions = region_permissions_t::of( region );
+        paths += region.path.native( );
+        page_count += ( region.end - region.start ) / page_size;
+        table.push_back( entry );
+      }
+
+      _internal::snapshot_header_t header { };
+      std::memcpy( header.magic, _internal::snapshot_magic, sizeof( header.magic ) );
+      header.version        = _internal::snapshot_version;
+      header.page_size      = static_cast<std::uint32_t>( page_size );
+      header.pid            = m_id;
+      header.region_count   = static_cast<std::uint32_t>( table.size( ) );
+      header.page_count     = page_count;
+      header.regions_offset = sizeof( header );
+      header.paths_offset   = header.regions_offset + table.size( ) * sizeof( snapshot_region_t );
+      header.pages_offset   = ( header.paths_offset + paths.size( ) + 7 ) & ~std::uint64_t { 7 };
+      header.data_offset    = header.pages_offset + page_count * sizeof( snapshot_page_t );
+      header.data_offset    = ( header.data_offset + page_size - 1 ) / page_size * page_size;
+
+      const auto now   = std::chrono::system_clock::now( ).time_since_epoch( );
+      header.timestamp = std::chrono::duration_cast<std::chrono::nanoseconds>( now ).count( );
+
+      const int fd = open( path.c_str( ), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644 );
+      if ( fd < 0 ) {
+#ifdef TRICKSTER_DEBUG
+        _internal::log<_internal::log_levels_t::error>(
+            tr_string( "Could not create snapshot %s. errno: %i (%s)" ),
+            path.c_str( ),
+            errno,
+            strerror( errno ) );
+#endif
+        return false;
+      }
+
+      std::vector<snapshot_page_t> pages( page_count, { snapshot_page_t::unreadable, 0 } );
+      std::vector<std::uint8_t>    buffer( options.chunk_size ), output( options.chunk_size );
+      std::vector<std::uint8_t>    stored( page_size );
+      std::unordered_map<std::uint64_t, std::uint64_t> unique;
+      bool                                             written = true;
+
+      // Page with equal hash is reused only if its stored contents match.
+      const auto same_as = [ & ]( std::uint64_t data, std::size_t pending, const std::uint8_t * contents ) {
+        const std::uint8_t * candidate = stored.data( );
+        if ( data >= header.data_page_count ) {
+          if ( data - header.data_page_count >= pending )
+            return false;
+          candidate = output.data( ) + ( data - header.data_page_count ) * page_size;
+        } else if ( pread( fd, stored.data( ), page_size, header.data_offset + data * page_size ) !=
+                    static_cast<ssize_t>( page_size ) ) {
+          return false;
+        }
+        return std::memcmp( candidate, contents, page_size ) == 0;
+      };
+
+      for ( std::size_t i = 0; i < table.size( ) && written; i++ ) {
+        const auto & region = table[ i ];
+        for ( auto start = region.start; start < region.end && written; start += options.chunk_size ) {
+          std::size_t        bytes_read = 0;
+          const read_entry_t entry { start,
+                                     buffer.data( ),
+                                     std::min<std::size_t>( options.chunk_size, region.end - start ) };
+          if ( options.ranges && !_internal::intersects( *options.ranges, start, start + entry.size ) )
+            continue;
+          if ( !read_scatter( &entry, 1, &bytes_read ).has_value( ) )
+            bytes_read = 0;
+
+          std::size_t pending = 0;
+          for ( std::size_t offset = 0; offset + page_size <= bytes_read; offset += page_size ) {
+            const auto address = start + offset;
+            if ( options.ranges && !_internal::intersects( *options.ranges, address, address + page_size ) )
+              continue;
+
+            const auto contents = buffer.data( ) + offset;
+            auto &     page     = pages[ region.first_page + ( start + offset - region.start ) / page_size ];
+            page.hash           = _internal::hash_page( contents, page_size );
+
+            if ( options.deduplicate ) {
+              const auto next                = header.data_page_count + pending;
+              const auto [ known, inserted ] = unique.try_emplace( page.hash, next );
+              if ( !inserted && same_as( known->second, pending, contents ) ) {
+                page.data = known->second;
+                continue;
+              }
+            }
+
+            std::memcpy( output.data( ) + pending * page_size, contents, page_size );
+            page.data = header.data_page_count + pending++;
+          }
+
+          const auto offset = header.data_offset + header.data_page_count * page_size;
+          written           = _internal::pwrite_all( fd, output.data( ), pending * page_size, offset );
+          header.data_page_count += pending;
+        }
+      }
+
+      // Tables go last, header and page table are complete only after all data was written.
+      const auto size = header.data_offset + header.data_page_count * page_size;
+      written         = written && _internal::pwrite_all( fd, &header, sizeof( header ), 0 ) &&
+                _internal::pwrite_all(
+                    fd, table.data( ), table.size( ) * sizeof( snapshot_region_t ), header.regions_offset ) &&
+                _internal::pwrite_all( fd, paths.data( ), paths.size( ), header.paths_offset ) &&
+                _internal::pwrite_all(
+                    fd, pages.data( ), pages.size( ) * sizeof( snapshot_page_t ), header.pages_offset ) &&
+                ftruncate( fd, static_cast<off_t>( size ) ) == 0;
+      close( fd );
+
+#ifdef TRICKSTER_DEBUG
+      if ( !written ) {
+        _internal::log<_internal::log_levels_t::error>( tr_string( "Could not write snapshot %s." ),
+                                                        path.c_str( ) );
+      }
+#endif
+      return written;
+    }
+
+    /**
+     * Get parsed ELF image of module. Image is opened on first use and cached
+     * by device and inode for all process objects, so later lookups (also after
+     * reattaching) do not parse it again. Concurrent lookups of the same image
+     * wait for single parse, lookups of other images are not blocked by it.
+     * Failures are not cached. File is looked up at its path and under
+     * /proc/$PID/root for processes in other mount namespaces.
+     * @param module module of this process.
+     * @return image or nullptr if file cannot be opened, is not the mapped one
+     * (inode differs) or is not a 64 bit ELF.
+     */
+    [[nodiscard]] std::shared_ptr<const elf_image_t> get_elf_image( const module_t & module ) const {
+      const _internal::elf_key_t key { module.inode, module.device_major, module.device_minor };
+      auto &                     cache = _internal::elf_cache( );
+      std::unique_lock           lock( cache.mutex );
+      if ( const auto cached = cache.images.find( key ); cached != cache.images.end( ) ) {
+        const auto pending = cached->second;
+        lock.unlock( );
+        return pending.get( );
+      }
+
+      std::promise<_internal::elf_cache_t::image_t> promise;
+      cache.images.emplace( key, promise.get_future( ).share( ) );
+      lock.unlock( );
+
+      // Waiters of this attempt get its result, lookups after the erase start a new one.
+      const auto forget = [ & ]( ) {
+        lock.lock( );
+        cache.images.erase( key );
+        lock.unlock( );
+      };
+
+      try {
+        auto image = _internal::open_elf_image( m_id, module );
+        if ( !image )
+          forget( );
+        promise.set_value( image );
+        return image;
+      } catch ( ... ) {
+        forget( );
+        promise.set_exception( std::current_exception( ) );
+        throw;
+      }
+    }
+
+    /**
+     * Resolve address of symbol defined by module. For STT_GNU_IFUNC symbols
+     * address of the resolver is returned, STT_TLS symbols are not resolved.
+     * @param module module of this process.
+     * @param symbol symbol name.
+     * @return address of the symbol in the process or std::nullopt.
+     */
+    [[nodiscard]] std::optional<std::uintptr_t> resolve_symbol( const module_t & module,
+                                                                std::string_view symbol ) const {
+      const auto image = get_elf_image( module );
+      if ( !image )
+        return std::nullopt;
+
+      const auto found = image->find( symbol );
+      if ( !found.has_value( ) || found->type == STT_TLS )
+        return std::nullopt;
+      return module.base - image->first_load( ) + found->value;
+    }
+
+    /**
+     * Resolve address of symbol defined by module.
+     * @param module filename (e.g. libc.so.6) or full path of the module.
+     * @param symbol symbol name.
+     * @return address of the symbol in the process or std::nullopt.
+     */
+    [[nodiscard]] std::optional<std::uintptr_t> resolve_symbol( std::string_view module,
+                                                                std::string_view symbol ) const {
+      const auto entry = find_module( module );
+      return entry ? resolve_symbol( *entry, symbol ) : std::nullopt;
+    }
+
+    /**
+     * Resolve address of symbol defined by any module, modules are searched in
+     * address order.
+     * @param symbol symbol name.
+     * @return address of the symbol in the process or std::nullopt.
+     */
+    [[nodiscard]] std::optional<std::uintptr_t> resolve_symbol( std::string_view symbol ) const {
+      for ( const auto & module : m_modules.modules( ) )
+        if ( const auto address = resolve_symbol( module, symbol ) )
+          return address;
+      return std::nullopt;
+    }
+
+    /**
+     * Decode x86-64 instruction and get address it references, generalization
+     * of get_call_address to rel32 jumps and RIP-relative operands.
+     * @param address address of the instruction.
+     * @return reference or std::nullopt if instruction could not be read,
+     * decoded or references nothing.
+     */
+    [[nodiscard]] std::optional<reference_t> decode_reference( std::uintptr_t address ) const {
+      std::uint8_t code[ 15 ];
+      read_entry_t entry { address, code, sizeof( code ) };
+      std::size_t  bytes_read = 0;
+      if ( !read_scatter( &entry, 1, &bytes_read ).has_value( ) || bytes_read == 0 )
+        return std::nullopt;
+      return _internal::reference_of( _internal::decode_x86_64( code, bytes_read ), code, address );
+    }
+
+    /**
+     * Get target of E8 rel32 call, backward calls included.
+     * @param address address of the call instruction.
+     * @return target address or std::nullopt if instruction could not be read
+     * or is not E8 call.
+     */
+    [[nodiscard]] std::optional<std::uintptr_t> get_call_address( std::uintptr_t address ) const {
+      tr_assert( is_valid( ), tr_string( "Process is invalid." ) );
+
+      const auto reference = decode_reference( address );
+      if ( reference.has_value( ) && reference->kind == reference_kind_t::call )
+        return static_cast<std::uintptr_t>( reference->target );
+
+#ifdef TRICKSTER_DEBUG
+      _internal::log<_internal::log_levels_t::error>(
+          tr_string( "Failed to get call address of %lx. Instruction is not E8 call or could not be read." ),
+          address );
+#endif
+      return std::nullopt;
+    }
+  };
+
+  namespace _internal {
+    template <typename T> struct field_value { using type = T; };
+    template <typename T, std::size_t N> struct field_value<T[ N ]> { using type = std::array<T, N>; };
+  } // namespace _internal
+
+  /**
+   * Field of remote structure, type and offset known at compile time.
+   * Array fields are fetched as std::array.
+   */
+  template <typename T, std::size_t Offset> struct field_t {
+    static_assert( std::is_trivially_copyable_v<T>, "Remote field requires trivially copyable type." );
+
+    using type                          = typename _internal::field_value<T>::type;
+    constexpr static std::size_t offset = Offset, size = sizeof( T );
+  };
+
+/**
+ * Field of remote structure mirrored by local type, e.g.
+ * tr_field( player_t, health ) for player_t::health.
+ */
+#define tr_field( type, member ) ::tr::field_t<decltype( type::member ), offsetof( type, member )>
+
+  namespace _internal {
+    /**
+     * Ranges of remote structure read to fetch the fields of remote_layout_t.
+     */
+    template <std::size_t N> struct layout_plan_t {
+      struct range_t {
+        /**
+         * Offset in the remote structure, size and position in the local buffer.
+         */
+        std::size_t offset, size, position;
+      };
+
+      std::array<range_t, N>     ranges { };
+      std::size_t                range_count = 0;
+      std::array<std::size_t, N> positions { };
+      std::size_t                buffer_size = 0;
+    };
+
+    /**
+     * Compute minimal covering ranges of fields: fields are sorted by offset,
+     * overlapping ones and ones at most gap bytes apart share one range.
+     */
+    template <std::size_t N>
+    constexpr layout_plan_t<N> make_layout_plan( const std::array<std::size_t, N> & offsets,
+                                                 const std::array<std::size_t, N> & sizes,
+                                                 std::size_t                        gap ) {
+      std::array<std::size_t, N> order { };
+      for ( std::size_t i = 0; i < N; i++ )
+        order[ i ] = i;
+      for ( std::size_t i = 1; i < N; i++ ) {
+        for ( std::size_t j = i; j > 0 && offsets[ order[ j ] ] < offsets[ order[ j - 1 ] ]; j-- ) {
+          const auto field = order[ j ];
+          order[ j ]       = order[ j - 1 ];
+          order[ j - 1 ]   = field;
+        }
+      }
+
+      layout_plan_t<N> plan { };
+      for ( std::size_t i = 0; i < N; i++ ) {
+        const auto field = order[ i ];
+        const auto start = offsets[ field ], end = start + sizes[ field ];
+        if ( plan.range_count != 0 ) {
+          auto &     last     = plan.ranges[ plan.range_count - 1 ];
+          const auto last_end = last.offset + last.size;
+          if ( start <= last_end + gap ) {
+            if ( end > last_end ) {
+              plan.buffer_size += end - last_end;
+              last.size = end - last.offset;
+            }
+            plan.positions[ field ] = last.position + ( start - last.offset );
+            continue;
+          }
+        }
+        plan.ranges[ plan.range_count++ ] = { start, end - start, plan.buffer_size };
+        plan.positions[ field ]           = plan.buffer_size;
+        plan.buffer_size += end - start;
+      }
+      return plan;
+    }
+  } // namespace _internal
+
+  /**
+   * Layout of remote structure as a selection of its fields. Minimal ranges
+   * covering the fields are computed at compile time, so fetching a structure
+   * is one vectored read of only those ranges instead of reading whole
+   * structure or every field separately. E.g.
+   *   using player_layout_t = tr::remote_layout_t<tr_field( player_t, health ), tr_field( player_t, name )>;
+   *   const auto player     = player_layout_t::fetch( process, address );
+   *   const auto health     = player->get<0>( );
+   * @tparam Fields field_t of every fetched field.
+   */
+  template <typename... Fields> class remote_layout_t {
+  public:
+    static_assert( sizeof...( Fields ) != 0, "Remote layout requires at least one field." );
+
+    /**
+     * Fields closer than this many bytes are read as one range.
+     */
+    constexpr static std::size_t merge_gap = 32;
+
+    constexpr static auto plan = _internal::make_layout_plan<sizeof...( Fields )>(
+        { Fields::offset... }, { Fields::size... }, merge_gap );
+
+    template <std::size_t I>
+    using field_type_t = typename std::tuple_element_t<I, std::tuple<Fields...>>::type;
+
+    /**
+     * Fetched fields of one structure.
+     */
+    class values_t {
+    private:
+      friend class remote_layout_t;
+
+      std::array<std::uint8_t, plan.buffer_size> m_buffer { };
+      bool                                       m_complete = false;
+
+    public:
+      /**
+       * Get value of field.
+       * @tparam I index of the field in the layout.
+       * @return value, zero if it was not read.
+       */
+      template <std::size_t I> [[nodiscard]] field_type_t<I> get( ) const noexcept {
+        field_type_t<I> value;
+        std::memcpy( std::addressof( value ), m_buffer.data( ) + plan.positions[ I ], sizeof( value ) );
+        return value;
+      }
+
+      /**
+       * Check if all ranges of the structure were read.
+       * @return state of statement above.
+       */
+      [[nodiscard]] bool complete( ) const noexcept { return m_complete; }
+    };
+
+    /**
+     * Fetch fields of many structures in one batched read.
+     * @param process process to read from.
+     * @param addresses addresses of the structures.
+     * @param count number of structures.
+     * @param out array of count elements receiving the fields.
+     * @return number of completely read structures or std::nullopt if process
+     * memory cannot be accessed.
+     */
+    static std::optional<std::size_t> fetch_many( const process_t &      process,
+                                                  const std::uintptr_t * addresses,
+                                                  std::size_t            count,
+                                                  values_t *             out ) {
+      std::vector<read_entry_t> entries( count * plan.range_count );
+      std::vector<std::size_t>  bytes_read( entries.size( ) );
+      for ( std::size_t i = 0; i < count; i++ ) {
+        for ( std::size_t range = 0; range < plan.range_count; range++ ) {
+          const auto & [ offset, size, position ] = plan.ranges[ range ];
+          entries[ i * plan.range_count + range ]  = {
+              addresses[ i ] + offset, out[ i ].m_buffer.data( ) + position, size };
+        }
+      }
+
+      if ( !process.read_scatter( entries.data( ), entries.size( ), bytes_read.data( ) ).has_value( ) )
+        return std::nullopt;
+
+      std::size_t complete = 0;
+      for ( std::size_t i = 0; i < count; i++ ) {
+        out[ i ].m_complete = true;
+        for ( std::size_t range = 0; range < plan.range_count; range++ )
+          out[ i ].m_complete &= bytes_read[ i * plan.range_count + range ] == plan.ranges[ range ].size;
+        complete += out[ i ].m_complete;
+      }
+      return complete;
+    }
+
+    /**
+     * Fetch fields of many structures in one batched read.
+     * @param process process to read from.
+     * @param addresses addresses of the structures.
+     * @param out receives the fields, resized to match addresses.
+     * @return number of completely read structures or std::nullopt if process
+     * memory cannot be accessed.
+     */
+    static std::optional<std::size_t> fetch_many( const process_t &                   process,
+                                                  const std::vector<std::uintptr_t> & addresses,
+                                                  std::vector<values_t> &             out ) {
+      out.resize( addresses.size( ) );
+      return fetch_many( process, addresses.data( ), addresses.size( ), out.data( ) );
+    }
+
+    /**
+     * Fetch fields of structure in one read.
+     * @param process process to read from.
+     * @param address address of the structure.
+     * @return fields or std::nullopt if any of them could not be read.
+     */
+    [[nodiscard]] static std::optional<values_t> fetch( const process_t & process, std::uintptr_t address ) {
+      values_t values;
+      if ( fetch_many( process, &address, 1, &values ).value_or( 0 ) != 1 )
+        return std::nullopt;
+      return values;
+    }
+  };
+
+  /**
+   * Remote span options.
+   */
+  struct remote_span_options_t {
+    /**
+     * Number of elements read at once.
+     */
+    std::size_t chunk_elements = 4096;
+
+    /**
+     * Read next chunk on a background thread while the current one is iterated.
+     * Otherwise chunks are read when iteration enters them.
+     */
+    bool background = false;
+  };
+
+  /**
+   * Range of elements in remote memory (array or std::vector storage), read
+   * in chunks while being iterated instead of one read per element. The cursor
+   * shared by iterators keeps three chunks: the previous one, the iterated one
+   * and, with background option, the next one, which is prefetched as soon as
+   * iteration enters the current one. Without background option chunks are
+   * read synchronously when iteration enters them.
+   * Iterators are input iterators, references are valid until the iterator
+   * leaves the chunk after the one they point into. Elements that cannot be
+   * read are zero.
+   * @tparam T trivially copyable element type.
+   */
+  template <typename T> class remote_span_t {
+    static_assert( std::is_trivially_copyable_v<T>, "Remote span requires trivially copyable type." );
+
+  private:
+    const process_t *     m_process;
+    std::uintptr_t        m_address;
+    std::size_t           m_size;
+    remote_span_options_t m_options;
+
+    class cursor_t {
+    private:
+      constexpr static std::size_t none = SIZE_MAX;
+
+      // Previous chunk stays readable while the next one is prefetched into the third slot.
+      constexpr static std::size_t slot_count = 3;
+
+      const process_t *       m_process;
+      std::uintptr_t          m_address;
+      std::size_t             m_size, m_chunk_elements, m_chunks;
+      std::vector<T>          m_slots;
+      std::size_t             m_loaded[ slot_count ] = { none, none, none };
+      std::thread             m_worker;
+      std::mutex              m_mutex;
+      std::condition_variable m_wake, m_done;
+      std::size_t             m_request  = none;
+      bool                    m_stopping = false;
+
+      T * slot( std::size_t chunk ) noexcept {
+        return m_slots.data( ) + ( chunk % slot_count ) * m_chunk_elements;
+      }
+
+      void load( std::size_t chunk ) {
+        const auto first = chunk * m_chunk_elements;
+        const auto count = std::min( m_chunk_elements, m_size - first );
+        const auto data  = slot( chunk );
+
+        read_entry_t entry { m_address + first * sizeof( T ), data, count * sizeof( T ) };
+        std::size_t  bytes_read = 0;
+        if ( !m_process->read_scatter( &entry, 1, &bytes_read ).has_value( ) )
+          bytes_read = 0;
+        std::memset( reinterpret_cast<std::uint8_t *>( data ) + bytes_read, 0, entry.size - bytes_read );
+        m_loaded[ chunk % slot_count ] = chunk;
+      }
+
+      void worker_loop( ) {
+        std::unique_lock lock( m_mutex );
+        for ( ;; ) {
+          m_wake.wait( lock, [ & ] { return m_stopping || m_request != none; } );
+          if ( m_stopping )
+            return;
+
+          // Main thread only touches the other slots while a request is pending.
+          const auto chunk = m_request;
+          lock.unlock( );
+          load( chunk );
+          lock.lock( );
+          m_request = none;
+          m_done.notify_all( );
+        }
+      }
+
+    public:
+      cursor_t( const process_t &             process,
+                std::uintptr_t                address,
+                std::size_t                   size,
+                const remote_span_options_t & options )
+          : m_process( &process ), m_address( address ), m_size( size ),
+            m_chunk_elements( options.chunk_elements ),
+            m_chunks( ( size + options.chunk_elements - 1 ) / options.chunk_elements ),
+            m_slots( std::min( m_chunks, slot_count ) * std::min( size, options.chunk_elements ) ) {
+        if ( options.background && m_chunks > 1 )
+          m_worker = std::thread( [ this ] { worker_loop( ); } );
+      }
+
+      ~cursor_t( ) {
+        if ( m_worker.joinable( ) ) {
+          {
+            std::lock_guard lock( m_mutex );
+            m_stopping = true;
+          }
+          m_wake.notify_all( );
+          m_worker.join( );
+        }
+      }
+
+      cursor_t( const cursor_t & )             = delete;
+      cursor_t & operator=( const cursor_t & ) = delete;
+
+      /**
+       * Make chunk current, reading it if needed, and with background worker
+       * start prefetching the next one.
+       * @return elements of the chunk.
+       */
+      const T * enter( std::size_t chunk ) {
+        if ( !m_worker.joinable( ) ) {
+          if ( m_loaded[ chunk % slot_count ] != chunk )
+            load( chunk );
+          return slot( chunk );
+        }
+
+        std::unique_lock lock( m_mutex );
+        m_done.wait( lock, [ & ] { return m_request == none; } );
+        if ( m_loaded[ chunk % slot_count ] != chunk )
+          load( chunk );
+        if ( chunk + 1 < m_chunks && m_loaded[ ( chunk + 1 ) % slot_count ] != chunk + 1 ) {
+          m_request = chunk + 1;
+          m_wake.notify_one( );
+        }
+        return slot( chunk );
+      }
+    };
+
+  public:
+    /**
+     * Iterator over elements of the span.
+     */
+    class iterator {
+    private:
+      std::shared_ptr<cursor_t> m_cursor;
+      const T *                 m_chunk = nullptr;
+      std::size_t               m_index = 0, m_chunk_elements = 1;
+
+    public:
+      using iterator_category = std::input_iterator_tag;
+      using value_type        = T;
+      using difference_type   = std::ptrdiff_t;
+      using pointer           = const T *;
+      using reference         = const T &;
+
+      iterator( ) = default;
+      iterator( std::shared_ptr<cursor_t> cursor, std::size_t index, std::size_t chunk_elements )
+          : m_cursor( std::move( cursor ) ), m_index( index ), m_chunk_elements( chunk_elements ) {
+        if ( m_cursor )
+          m_chunk = m_cursor->enter( 0 );
+      }
+
+      [[nodiscard]] reference operator*( ) const noexcept { return m_chunk[ m_index % m_chunk_elements ]; }
+      [[nodiscard]] pointer   operator->( ) const noexcept { return &**this; }
+
+      iterator & operator++( ) {
+        if ( ++m_index % m_chunk_elements == 0 )
+          m_chunk = m_cursor->enter( m_index / m_chunk_elements );
+        return *this;
+      }
+
+      /**
+       * Get index of the element in the span.
+       * @return index of the element.
+       */
+      [[nodiscard]] std::size_t index( ) const noexcept { return m_index; }
+
+      [[nodiscard]] bool operator==( const iterator & other ) const noexcept {
+        return m_index == other.m_index;
+      }
+      [[nodiscard]] bool operator!=( const iterator & other ) const noexcept {
+        return m_index != other.m_index;
+      }
+    };
+
+    /**
+     * Create span of remote elements.
+     * @param process process the elements are read from.
+     * @param address address of the first element.
+     * @param size number of elements.
+     * @param options span options.
+     */
+    remote_span_t( const process_t &             process,
+                   std::uintptr_t                address,
+                   std::size_t                   size,
+                   const remote_span_options_t & options = { } )
+        : m_process( &process ), m_address( address ), m_size( size ), m_options( options ) {
+      tr_assert( m_options.chunk_elements != 0, tr_string( "Chunk has to hold at least one element." ) );
+    }
+
+    /**
+     * Create span of remote std::vector storage. Vector is expected to start
+     * with begin and end pointers, as it does in libstdc++ and libc++.
+     * @param process process the vector is read from.
+     * @param address address of the std::vector object.
+     * @param options span options.
+     * @return span or std::nullopt if vector could not be read or is not valid.
+     */
+    [[nodiscard]] static std::optional<remote_span_t>
+    from_vector( const process_t &             process,
+                 std::uintptr_t                address,
+                 const remote_span_options_t & options = { } ) {
+      const auto pointers = process.read_memory<std::array<std::uintptr_t, 2>>( address );
+      if ( !pointers.has_value( ) || pointers->partial_read )
+        return std::nullopt;
+
+      const auto [ first, last ] = pointers->data;
+      if ( last < first || ( last - first ) % sizeof( T ) != 0 )
+        return std::nullopt;
+      return remote_span_t( process, first, ( last - first ) / sizeof( T ), options );
+    }
+
+    [[nodiscard]] iterator begin( ) const {
+      if ( m_size == 0 )
+        return end( );
+      return iterator( std::make_shared<cursor_t>( *m_process, m_address, m_size, m_options ),
+                       0,
+                       m_options.chunk_elements );
+    }
+    [[nodiscard]] iterator end( ) const { return iterator( nullptr, m_size, m_options.chunk_elements ); }
+
+    [[nodiscard]] std::size_t    size( ) const noexcept { return m_size; }
+    [[nodiscard]] bool           empty( ) const noexcept { return m_size == 0; }
+    [[nodiscard]] std::uintptr_t address( ) const noexcept { return m_address; }
+
+    /**
+     * Read all elements at once.
+     * @param out receives the elements, resized to size(). Elements that
+     * could not be read are zero.
+     * @return number of bytes read or std::nullopt if process memory cannot be accessed.
+     */
+    std::optional<std::size_t> read( std::vector<T> & out ) const {
+      out.assign( m_size, T { } );
+      read_entry_t entry { m_address, out.data( ), m_size * sizeof( T ) };
+      std::size_t  bytes_read = 0;
+      if ( !m_process->read_scatter( &entry, 1, &bytes_read ).has_value( ) )
+        return std::nullopt;
+      return bytes_read;
+    }
+
+    /**
+     * Read elements the pointer elements point to, in one batched read.
+     * @tparam U trivially copyable type of the pointees.
+     * @param out receives the pointees, resized to size().
+     * @param offset offset added to every pointer.
+     * @param bytes_read optional per pointee bytes read. See read_scatter.
+     * @return number of fully read pointees or std::nullopt if process memory
+     * cannot be accessed.
+     */
+    template <typename U>
+    std::optional<std::size_t> gather( std::vector<U> &           out,
+                                       std::ptrdiff_t             offset     = 0,
+                                       std::vector<std::size_t> * bytes_read = nullptr ) const {
+      const auto addresses = pointees( offset );
+      if ( !addresses.has_value( ) )
+        return std::nullopt;
+      return m_process->read_many( *addresses, out, bytes_read );
+    }
+
+    /**
+     * Fetch fields of the structures the pointer elements point to, in one
+     * batched read.
+     * @tparam Layout remote_layout_t of the pointees.
+     * @param out receives the fields, resized to size().
+     * @param offset offset added to every pointer.
+     * @return number of completely read structures or std::nullopt if process
+     * memory cannot be accessed.
+     */
+    template <typename Layout>
+    std::optional<std::size_t> gather_fields( std::vector<typename Layout::values_t> & out,
+                                              std::ptrdiff_t                           offset = 0 ) const {
+      const auto addresses = pointees( offset );
+      if ( !addresses.has_value( ) )
+        return std::nullopt;
+      return Layout::fetch_many( *m_process, *addresses, out );
+    }
+
+  private:
+    std::optional<std::vector<std::uintptr_t>> pointees( std::ptrdiff_t offset ) const {
+      static_assert( std::is_pointer_v<T> ||
+                         ( std::is_integral_v<T> && sizeof( T ) == sizeof( std::uintptr_t ) ),
+                     "Gathering requires pointer elements." );
+
+      std::vector<T> pointers;
+      if ( !read( pointers ).has_value( ) )
+        return std::nullopt;
+
+      std::vector<std::uintptr_t> addresses( pointers.size( ) );
+      for ( std::size_t i = 0; i < pointers.size( ); i++ ) {
+        if constexpr ( std::is_pointer_v<T> )
+          addresses[ i ] = reinterpret_cast<std::uintptr_t>( pointers[ i ] ) + offset;
+        else
+          addresses[ i ] = static_cast<std::uintptr_t>( pointers[ i ] ) + offset;
+      }
+      return addresses;
+    }
+  };
+
+  /**
+   * Condition candidate value is tested with by value_scanner_t.
+   * changed, unchanged, increased and decreased compare with the value from
+   * the previous scan and can be used only by next scans. Ordering conditions
+   * (greater, less, between, increased, decreased) require arithmetic type.
+   */
+  enum class scan_condition_t : std::uint8_t {
+    equal = 0,
+    not_equal,
+    greater,
+    less,
+    between,
+    unknown,
+    changed,
+    unchanged,
+    increased,
+    decreased
+  };
+
+  /**
+   * Value scan options.
+   */
+  struct value_scan_options_t {
+    /**
+     * Alignment of scanned addresses, 0 means alignof(T). Has to be a power of 2.
+     */
+    std::size_t alignment = 0;
+
+    /**
+     * Scan only writable regions.
+     */
+    bool writable_only = true;
+
+    /**
+     * Size of memory read at once and of a candidate block, at most 4 GiB.
+     */
+    std::size_t chunk_size = 1 << 20;
+
+    /**
+     * Thread pool scan is split across (default: thread_pool_t::shared()).
+     */
+    thread_pool_t * pool = nullptr;
+  };
+
+  /**
+   * Cheat Engine style value scanner. First scan collects candidate addresses
+   * from all scanned regions, next scans re-read only the candidates and keep
+   * the ones still satisfying the condition.
+   *
+   * Candidates are grouped in blocks of chunk_size bytes. Sparse blocks store
+   * sorted 32 bit offsets, dense blocks (more than 1 candidate per 32 slots)
+   * store a bitmap with one bit per aligned slot. Values of candidates are
+   * kept to evaluate conditions relative to the previous scan.
+   *
+   * Strings can be scanned as fixed length character arrays, e.g.
+   * value_scanner_t<std::array<char, 5>>.
+   */
+  template <typename T> class value_scanner_t {
+    static_assert( std::is_trivially_copyable_v<T>, "Scanned type has to be trivially copyable." );
+
+  private:
+    struct block_t {
+      std::uintptr_t             base;
+      std::size_t                size;
+      std::size_t                count;
+      bool                       anonymous;
+      std::vector<std::uint32_t> offsets;
+      std::vector<std::uint64_t> bitmap;
+      std::vector<T>             values;
+    };
+
+    // Candidates separated by less than this are fetched with a single read.
+    constexpr static std::size_t run_gap = 256;
+
+    const process_t &    m_process;
+    value_scan_options_t m_options;
+    std::vector<block_t> m_blocks;
+    bool                 m_scanned = false;
+
+    [[nodiscard]] std::size_t alignment( ) const noexcept {
+      return m_options.alignment != 0 ? m_options.alignment : alignof( T );
+    }
+
+    [[nodiscard]] thread_pool_t & pool( ) const {
+      return m_options.pool ? *m_options.pool : thread_pool_t::shared( );
+    }
+
+    [[nodiscard]] static bool test( scan_condition_t condition,
+                                    const T &        current,
+                                    const T &        previous,
+                                    const T &        value,
+                                    const T &        upper ) {
+      const auto same = []( const T & lhs, const T & rhs ) {
+        if constexpr ( std::is_arithmetic_v<T> )
+          return lhs == rhs;
+        else
+          return std::memcmp( &lhs, &rhs, sizeof( T ) ) == 0;
+      };
+
+      switch ( condition ) {
+        case scan_condition_t::equal: return same( current, value );
+        case scan_condition_t::not_equal: return !same( current, value );
+        case scan_condition_t::unknown: return true;
+        case scan_condition_t::changed: return !same( current, previous );
+        case scan_condition_t::unchanged: return same( current, previous );
+        default: break;
+      }
+
+      if constexpr ( std::is_arithmetic_v<T> ) {
+        switch ( condition ) {
+          case scan_condition_t::greater: return current > value;
+          case scan_condition_t::less: return current < value;
+          case scan_condition_t::between: return current >= value && current <= upper;
+          case scan_condition_t::increased: return current > previous;
+          case scan_condition_t::decreased: return current < previous;
+          default: break;
+        }
+      }
+      return false;
+    }
+
+    /**
+     * Store candidate offsets into block choosing sparse or dense representation.
+     */
+    void store( block_t & block, std::vector<std::uint32_t> & offsets, std::vector<T> & values ) const {
+      const auto slots = block.size / alignment( );
+      block.count      = offsets.size( );
+      block.values     = std::move( values );
+      block.values.shrink_to_fit( );
+
+      if ( offsets.size( ) * 32 > slots ) {
+        block.bitmap.assign( ( slots + 63 ) / 64, 0 );
+        for ( const auto offset : offsets ) {
+          const auto slot = offset / alignment( );
+          block.bitmap[ slot / 64 ] |= std::uint64_t { 1 } << ( slot % 64 );
+        }
+        block.offsets.clear( );
+        block.offsets.shrink_to_fit( );
+      } else {
+        block.offsets = std::move( offsets );
+        block.offsets.shrink_to_fit( );
+        block.bitmap.clear( );
+        block.bitmap.shrink_to_fit( );
+      }
+    }
+
+    template <typename F> void for_each_offset( const block_t & block, F && callback ) const {
+      if ( block.bitmap.empty( ) ) {
+        for ( const auto offset : block.offsets )
+          callback( offset );
+        return;
+      }
+
+      for ( std::size_t word = 0; word < block.bitmap.size( ); word++ ) {
+        for ( auto bits = block.bitmap[ word ]; bits != 0; bits &= bits - 1 )
+          callback( static_cast<std::uint32_t>( ( word * 64 + __builtin_ctzll( bits ) ) * alignment( ) ) );
+      }
+    }
+
+    /**
+     * Evaluate condition for all aligned slots of freshly read block.
+     * Only slots fully inside one of the parts (begin and end offsets, in
+     * order) hold process memory and are tested.
+     */
+    void scan_buffer( block_t &                                                block,
+                      const std::uint8_t *                                     data,
+                      const std::vector<std::pair<std::size_t, std::size_t>> & parts,
+                      scan_condition_t                                         condition,
+                      const T &                                                value,
+                      const T &                                                upper ) const {
+      std::vector<std::uint32_t> offsets;
+      std::vector<T>             values;
+
+      const auto add = [ & ]( std::size_t offset ) {
+        T current;
+        std::memcpy( &current, data + offset, sizeof( T ) );
+        offsets.push_back( static_cast<std::uint32_t>( offset ) );
+        values.push_back( current );
+      };
+
+      if constexpr ( !std::is_floating_point_v<T> ) {
+        if ( condition == scan_condition_t::equal ) {
+          // Exact bytes, the SIMD pattern kernel finds them much faster than testing every slot.
+          pattern_t pattern;
+          pattern.bytes.resize( sizeof( T ) );
+          pattern.mask.assign( sizeof( T ), 0xFF );
+          std::memcpy( pattern.bytes.data( ), &value, sizeof( T ) );
+
+          for ( const auto & part : parts ) {
+            const auto begin = part.first;
+            const auto on_match = [ & ]( std::size_t offset ) {
+              if ( begin + offset >= block.size )
+                return false;
+              if ( ( begin + offset ) % alignment( ) == 0 )
+                add( begin + offset );
+              return true;
+            };
+            _internal::match_pattern( data + begin, part.second - begin, pattern, on_match );
+          }
+          store( block, offsets, values );
+          return;
+        }
+      }
+
+      const auto step = alignment( );
+      for ( const auto & [ begin, end ] : parts ) {
+        const auto first = ( begin + step - 1 ) / step * step;
+        for ( auto offset = first; offset < block.size && offset + sizeof( T ) <= end; offset += step ) {
+          T current;
+          std::memcpy( &current, data + offset, sizeof( T ) );
+          if ( test( condition, current, current, value, upper ) ) {
+            offsets.push_back( static_cast<std::uint32_t>( offset ) );
+            values.push_back( current );
+          }
+        }
+      }
+      store( block, offsets, values );
+    }
+
+    /**
+     * Re-read candidates of the block in batches and keep the matching ones.
+     * Candidates outside dirty ranges are not read, their value is unchanged.
+     */
+    void rescan_block( block_t &                         block,
+                       std::vector<std::uint8_t> &       buffer,
+                       std::vector<read_entry_t> &       runs,
+                       std::vector<std::size_t> &        bytes_read,
+                       scan_condition_t                  condition,
+                       const T &                         value,
+                       const T &                         upper,
+                       const std::vector<page_range_t> * dirty ) const {
+      std::vector<std::uint32_t> candidates;
+      candidates.reserve( block.count );
+      for_each_offset( block, [ & ]( std::uint32_t offset ) { candidates.push_back( offset ); } );
+
+      std::vector<std::uint8_t> clean( candidates.size( ), 0 );
+      if ( dirty ) {
+        if ( !_internal::intersects( *dirty, block.base, block.base + block.size ) )
+          std::fill( clean.begin( ), clean.end( ), 1 );
+        else
+          for ( std::size_t i = 0; i < candidates.size( ); i++ ) {
+            const auto address = block.base + candidates[ i ];
+            clean[ i ]         = !_internal::intersects( *dirty, address, address + sizeof( T ) );
+          }
+      }
+
+      // Group nearby candidates into runs, buffer addresses are filled in after it is sized.
+      runs.clear( );
+      std::size_t buffer_size = 0;
+      for ( std::size_t i = 0; i < candidates.size( ); i++ ) {
+        if ( clean[ i ] )
+          continue;
+
+        const auto address = block.base + candidates[ i ];
+        if ( !runs.empty( ) && address <= runs.back( ).address + runs.back( ).size + run_gap ) {
+          const auto end = std::max( runs.back( ).address + runs.back( ).size, address + sizeof( T ) );
+          buffer_size += end - ( runs.back( ).address + runs.back( ).size );
+          runs.back( ).size = end - runs.back( ).address;
+        } else {
+          runs.push_back( { address, nullptr, sizeof( T ) } );
+          buffer_size += sizeof( T );
+        }
+      }
+
+      buffer.resize( buffer_size );
+      std::size_t position = 0;
+      for ( auto & run : runs ) {
+        run.buffer = buffer.data( ) + position;
+        position += run.size;
+      }
+
+      bytes_read.resize( runs.size( ) );
+      if ( !m_process.read_scatter( runs.data( ), runs.size( ), bytes_read.data( ) ).has_value( ) )
+        std::fill( bytes_read.begin( ), bytes_read.end( ), 0 );
+
+      std::vector<std::uint32_t> offsets;
+      std::vector<T>             values;
+      std::size_t                run = 0;
+      for ( std::size_t i = 0; i < candidates.size( ); i++ ) {
+        if ( clean[ i ] ) {
+          if ( test( condition, block.values[ i ], block.values[ i ], value, upper ) ) {
+            offsets.push_back( candidates[ i ] );
+            values.push_back( block.values[ i ] );
+          }
+          continue;
+        }
+
+        const auto address = block.base + candidates[ i ];
+        while ( address >= runs[ run ].address + runs[ run ].size )
+          run++;
+
+        const auto run_offset = address - runs[ run ].address;
+        if ( run_offset + sizeof( T ) > bytes_read[ run ] )
+          continue;
+
+        T current;
+        const auto data = static_cast<const std::uint8_t *>( runs[ run ].buffer );
+        std::memcpy( &current, data + run_offset, sizeof( T ) );
+        if ( test( condition, current, block.values[ i ], value, upper ) ) {
+          offsets.push_back( candidates[ i ] );
+          values.push_back( current );
+        }
+      }
+      store( block, offsets, values );
+    }
+
+  public:
+    /**
+     * Create value scanner.
+     * @param process process to scan, its regions have to be mapped before first scan.
+     * @param options scan options.
+     */
+    explicit value_scanner_t( const process_t & process, const value_scan_options_t & options = { } )
+        : m_process( process ), m_options( options ) {
+      tr_assert( ( alignment( ) & ( alignment( ) - 1 ) ) == 0,
+                 tr_string( "Alignment is not a power of 2." ) );
+      tr_assert( m_options.chunk_size % alignment( ) == 0, tr_string( "Chunk size is not aligned." ) );
+      tr_assert( m_options.chunk_size <= ( std::size_t { 1 } << 32 ),
+                 tr_string( "Chunk size exceeds 4 GiB." ) );
+    }
+
+    /**
+     * Scan all readable (and by default writable) regions for candidates.
+     * Discards results of previous scans.
+     * @param condition condition to test, cannot refer to previous scan.
+     * @param value value to compare with.
+     * @param upper upper bound for between condition.
+     * @return number of candidates.
+     */
+    std::size_t first_scan( scan_condition_t condition, const T & value = { }, const T & upper = { } ) {
+      tr_assert( condition < scan_condition_t::changed,
+                 tr_string( "First scan cannot compare with previous scan." ) );
+
+      m_blocks.clear( );
+      for ( const auto & region : m_process.get_memory_regions( ) ) {
+        if ( !region.readable || ( m_options.writable_only && !region.writable ) )
+          continue;
+
+        for ( auto start = region.start; start < region.end; start += m_options.chunk_size ) {
+          block_t block;
+          block.base      = start;
+          block.size      = std::min<std::uintptr_t>( m_options.chunk_size, region.end - start );
+          block.count     = 0;
+          block.anonymous = _internal::is_private_anonymous( region );
+          m_blocks.push_back( std::move( block ) );
+        }
+      }
+
+      auto &                                 threads = pool( );
+      std::vector<std::vector<std::uint8_t>> buffers( threads.size( ) );
+
+      threads.parallel_for( m_blocks.size( ), [ & ]( std::size_t index, std::size_t worker ) {
+        auto & block  = m_blocks[ index ];
+        auto & buffer = buffers[ worker ];
+        buffer.resize( block.size );
+
+        // Untouched anonymous pages are read as zeros without faulting them in.
+        std::vector<std::pair<std::size_t, std::size_t>> parts;
+        const auto collect = [ &parts ]( std::size_t begin, std::size_t end ) {
+          parts.emplace_back( begin, end );
+        };
+        if ( !m_process.read_scannable( block.base, buffer.data( ), block.size, block.anonymous, collect ) )
+          return;
+
+        scan_buffer( block, buffer.data( ), parts, condition, value, upper );
+      } );
+
+      m_blocks.erase( std::remove_if( m_blocks.begin( ),
+                                      m_blocks.end( ),
+                                      []( const block_t & block ) { return block.count == 0; } ),
+                      m_blocks.end( ) );
+      m_scanned = true;
+      return size( );
+    }
+
+    /**
+     * Re-read candidates and keep the ones satisfying the condition.
+     * @param condition condition to test.
+     * @param value value to compare with.
+     * @param upper upper bound for between condition.
+     * @param dirty optional sorted ranges written since the previous scan, e.g.
+     * collected by dirty_tracker_t. Candidates outside them are not read and
+     * are tested with their previous value.
+     * @return number of remaining candidates.
+     */
+    std::size_t next_scan( scan_condition_t                  condition,
+                           const T &                         value = { },
+                           const T &                         upper = { },
+                           const std::vector<page_range_t> * dirty = nullptr ) {
+      tr_assert( m_scanned, tr_string( "Next scan requires first scan." ) );
+
+      auto &                                 threads = pool( );
+      std::vector<std::vector<std::uint8_t>> buffers( threads.size( ) );
+      std::vector<std::vector<read_entry_t>> runs( threads.size( ) );
+      std::vector<std::vector<std::size_t>>  bytes_read( threads.size( ) );
+
+      threads.parallel_for( m_blocks.size( ), [ & ]( std::size_t index, std::size_t worker ) {
+        rescan_block( m_blocks[ index ],
+                      buffers[ worker ],
+                      runs[ worker ],
+                      bytes_read[ worker ],
+                      condition,
+                      value,
+                      upper,
+                      dirty );
+      } );
+
+      m_blocks.erase( std::remove_if( m_blocks.begin( ),
+                                      m_blocks.end( ),
+                                      []( const block_t & block ) { return block.count == 0; } ),
+                      m_blocks.end( ) );
+      return size( );
+    }
+
+    /**
+     * Get number of candidates.
+     * @return number of candidates left after the last scan.
+     */
+    [[nodiscard]] std::size_t size( ) const noexcept {
+      std::size_t count = 0;
+      for ( const auto & block : m_blocks )
+        count += block.count;
+      return count;
+    }
+
+    /**
+     * Invoke callback for every candidate in increasing address order.
+     * @param callback invoked with address and value read by the last scan.
+     */
+    template <typename F> void for_each( F && callback ) const {
+      for ( const auto & block : m_blocks ) {
+        std::size_t i = 0;
+        for_each_offset( block, [ & ]( std::uint32_t offset ) {
+          callback( block.base + offset, block.values[ i++ ] );
+        } );
+      }
+    }
+
+    /**
+     * Get candidate addresses.
+     * @param limit maximum number of addresses, 0 means no limit.
+     * @return sorted candidate addresses.
+     */
+    [[nodiscard]] std::vector<std::uintptr_t> addresses( std::size_t limit = 0 ) const {
+      std::vector<std::uintptr_t> result;
+      result.reserve( limit != 0 ? std::min( limit, size( ) ) : size( ) );
+      for_each( [ & ]( std::uintptr_t address, const T & ) {
+        if ( limit == 0 || result.size( ) < limit )
+          result.push_back( address );
+      } );
+      return result;
+    }
+
+    /**
+     * Discard all candidates.
+     */
+    void reset( ) {
+      m_blocks.clear( );
+      m_scanned = false;
+    }
+  };
+
+  /**
+   * Pointer scan options.
+   */
+  struct pointer_scan_options_t {
+    /**
+     * Maximum number of dereferences in a path.
+     */
+    std::size_t max_depth = 5;
+
+    /**
+     * Maximum offset added to a pointer at every level, at most 4 GiB.
+     */
+    std::size_t max_offset = 0x1000;
+
+    /**
+     * Stop after this many paths, 0 means no limit.
+     */
+    std::size_t max_results = 0;
+
+    /**
+     * Maximum number of addresses explored by the search, bounds its memory.
+     */
+    std::size_t max_nodes = 1 << 24;
+
+    /**
+     * Size of memory read at once.
+     */
+    std::size_t chunk_size = 1 << 20;
+
+    /**
+     * Memory for pointer map entries collected in memory. Bigger maps are
+     * spilled to a file in sorted runs and merged into a memory mapped file.
+     */
+    std::size_t memory_limit = std::size_t { 256 } << 20;
+
+    /**
+     * Directory of spill files (default: std::filesystem::temp_directory_path()).
+     */
+    std::filesystem::path spill_directory;
+
+    /**
+     * Thread pool scan is split across (default: thread_pool_t::shared()).
+     */
+    thread_pool_t * pool = nullptr;
+  };
+
+  namespace _internal {
+    /**
+     * Open anonymous file, removed as soon as it is closed.
+     * @param directory directory of the file.
+     * @return file descriptor or -1.
+     */
+    inline int open_temporary_file( const std::filesystem::path & directory ) {
+#ifdef O_TMPFILE
+      if ( const int fd = open( directory.c_str( ), O_TMPFILE | O_RDWR | O_CLOEXEC, 0600 ); fd >= 0 )
+        return fd;
+#endif
+      auto      path = ( directory / tr_string( "tr-XXXXXX" ) ).string( );
+      const int fd   = mkstemp( path.data( ) );
+      if ( fd >= 0 )
+        unlink( path.c_str( ) );
+      return fd;
+    }
+
+    /**
+     * Write whole buffer to file.
+     * @param fd file descriptor.
+     * @param data data to write.
+     * @param size size of the data.
+     * @return true if everything was written, false otherwise.
+     */
+    inline bool write_all( int fd, const void * data, std::size_t size ) {
+      auto position = static_cast<const std::uint8_t *>( data );
+      while ( size != 0 ) {
+        const auto result = write( fd, position, size );
+        if ( result < 0 && errno == EINTR )
+          continue;
+        if ( result <= 0 )
+          return false;
+        position += result;
+        size -= static_cast<std::size_t>( result );
+      }
+      return true;
+    }
+  } // namespace _internal
+
+  /**
+   * Reverse pointer map, every 8 byte aligned value in readable regions of the
+   * process pointing into a mapped region, sorted by the address it points to.
+   * Map is kept in memory while it fits options.memory_limit, otherwise sorted
+   * runs are spilled to a file and merged into a memory mapped file.
+   */
+  class pointer_map_t {
+  public:
+    struct entry_t {
+      std::uint64_t target, source;
+
+      [[nodiscard]] bool operator<( const entry_t & other ) const noexcept {
+        return target != other.target ? target < other.target : source < other.source;
+      }
+    };
+
+  private:
+    std::vector<entry_t> m_memory;
+    const entry_t *      m_entries      = nullptr;
+    std::size_t          m_size         = 0;
+    void *               m_mapping      = nullptr;
+    std::size_t          m_mapping_size = 0;
+
+    void release( ) {
+      if ( m_mapping )
+        munmap( m_mapping, m_mapping_size );
+      m_mapping = nullptr;
+      m_memory.clear( );
+      m_memory.shrink_to_fit( );
+      m_entries = nullptr;
+      m_size    = 0;
+    }
+
+    /**
+     * Merge sorted runs of the spill file into a new file and map it.
+     */
+    bool merge( int                                                  spill_fd,
+                const std::vector<std::pair<std::size_t, std::size_t>> & runs,
+                std::size_t                                          total,
+                const std::filesystem::path &                        directory ) {
+      const auto input_size = total * sizeof( entry_t );
+      const auto input      = mmap( nullptr, input_size, PROT_READ, MAP_PRIVATE, spill_fd, 0 );
+      if ( input == MAP_FAILED )
+        return false;
+      madvise( input, input_size, MADV_SEQUENTIAL );
+
+      const int output_fd = _internal::open_temporary_file( directory );
+      if ( output_fd < 0 ) {
+        munmap( input, input_size );
+        return false;
+      }
+
+      // Min heap of run heads, position is index of the head in the spill file.
+      struct head_t {
+        entry_t     entry;
+        std::size_t position, end;
+      };
+      const auto           entries = static_cast<const entry_t *>( input );
+      const auto later = []( const head_t & lhs, const head_t & rhs ) { return rhs.entry < lhs.entry; };
+      std::vector<head_t>  heads;
+      std::vector<entry_t> output;
+      bool                 written = true;
+
+      for ( const auto & [ offset, count ] : runs )
+        heads.push_back( { entries[ offset ], offset, offset + count } );
+      std::make_heap( heads.begin( ), heads.end( ), later );
+
+      output.reserve( 1 << 16 );
+      while ( !heads.empty( ) && written ) {
+        std::pop_heap( heads.begin( ), heads.end( ), later );
+        auto & head = heads.back( );
+        output.push_back( head.entry );
+        if ( ++head.position < head.end ) {
+          head.entry = entries[ head.position ];
+          std::push_heap( heads.begin( ), heads.end( ), later );
+        } else {
+          heads.pop_back( );
+        }
+
+        if ( output.size( ) == output.capacity( ) || heads.empty( ) ) {
+          written = _internal::write_all( output_fd, output.data( ), output.size( ) * sizeof( entry_t ) );
+          output.clear( );
+        }
+      }
+      munmap( input, input_size );
+
+      if ( written ) {
+        m_mapping = mmap( nullptr, input_size, PROT_READ, MAP_SHARED, output_fd, 0 );
+        if ( m_mapping == MAP_FAILED )
+          m_mapping = nullptr;
+      }
+      close( output_fd );
+      if ( !m_mapping )
+        return false;
+
+      m_mapping_size = input_size;
+      m_entries      = static_cast<const entry_t *>( m_mapping );
+      m_size         = total;
+      return true;
+    }
+
+  public:
+    pointer_map_t( )                                   = default;
+    pointer_map_t( const pointer_map_t & )             = delete;
+    pointer_map_t & operator=( const pointer_map_t & ) = delete;
+
+    ~pointer_map_t( ) { release( ); }
+
+    /**
+     * Build map of the process, discarding previous contents.
+     * @param process process to scan, its regions have to be mapped.
+     * @param options scan options.
+     * @return true if map was built, false if spill file could not be written.
+     */
+    bool build( const process_t & process, const pointer_scan_options_t & options = { } ) {
+      release( );
+
+      const auto & regions = process.get_memory_regions( );
+      const auto & index   = process.get_region_index( );
+      if ( regions.empty( ) )
+        return true;
+
+      std::vector<read_entry_t> chunks;
+      std::vector<std::uint8_t> anonymous;
+      for ( const auto & region : regions ) {
+        if ( !region.readable )
+          continue;
+        for ( auto start = region.start; start < region.end; start += options.chunk_size ) {
+          chunks.push_back(
+              { start, nullptr, std::min<std::uintptr_t>( options.chunk_size, region.end - start ) } );
+          anonymous.push_back( _internal::is_private_anonymous( region ) );
+        }
+      }
+
+      auto &     threads  = options.pool ? *options.pool : thread_pool_t::shared( );
+      const auto per_worker = options.memory_limit / threads.size( );
+      const auto capacity   = std::max<std::size_t>( per_worker / sizeof( entry_t ), 1 );
+      const auto lowest     = regions.front( ).start;
+      const auto highest    = regions.back( ).end;
+      const auto directory  = options.spill_directory.empty( ) ? std::filesystem::temp_directory_path( )
+                                                               : options.spill_directory;
+
+      std::vector<std::vector<std::uint8_t>>           buffers( threads.size( ) );
+      std::vector<std::vector<entry_t>>                entries( threads.size( ) );
+      std::vector<std::pair<std::size_t, std::size_t>> runs;
+      std::mutex                                       spill_mutex;
+      int                                              spill_fd = -1;
+      std::size_t                                      spilled  = 0;
+      std::atomic<bool>                                failed { false };
+
+      const auto spill = [ & ]( std::vector<entry_t> & run ) {
+        std::sort( run.begin( ), run.end( ) );
+
+        std::lock_guard<std::mutex> lock( spill_mutex );
+        if ( spill_fd < 0 )
+          spill_fd = _internal::open_temporary_file( directory );
+        if ( spill_fd < 0 ||
+             !_internal::write_all( spill_fd, run.data( ), run.size( ) * sizeof( entry_t ) ) ) {
+          failed.store( true, std::memory_order_relaxed );
+        } else {
+          runs.emplace_back( spilled, run.size( ) );
+          spilled += run.size( );
+        }
+        run.clear( );
+      };
+
+      threads.parallel_for( chunks.size( ), [ & ]( std::size_t chunk, std::size_t worker ) {
+        if ( failed.load( std::memory_order_relaxed ) )
+          return;
+
+        auto & buffer = buffers[ worker ];
+        auto & found  = entries[ worker ];
+        auto   entry  = chunks[ chunk ];
+        buffer.resize( entry.size );
+        entry.buffer = buffer.data( );
+
+        // Untouched anonymous pages hold no pointers, they are skipped without being faulted in.
+        constexpr std::size_t word = sizeof( std::uint64_t );
+        const auto            scan = [ & ]( std::size_t begin, std::size_t end ) {
+          for ( auto offset = ( begin + word - 1 ) / word * word; offset + word <= end; offset += word ) {
+            std::uint64_t value;
+            std::memcpy( &value, buffer.data( ) + offset, sizeof( value ) );
+            if ( value < lowest || value >= highest || index.find( value ) == region_index_t::npos )
+              continue;
+
+            found.push_back( { value, entry.address + offset } );
+            if ( found.size( ) == capacity )
+              spill( found );
+          }
+        };
+        (void)process.read_scannable( entry.address, buffer.data( ), entry.size, anonymous[ chunk ], scan );
+      } );
+
+      if ( runs.empty( ) && !failed.load( ) ) {
+        std::size_t total = 0;
+        for ( const auto & found : entries )
+          total += found.size( );
+
+        m_memory.reserve( total );
+        for ( auto & found : entries ) {
+          m_memory.insert( m_memory.end( ), found.begin( ), found.end( ) );
+          std::vector<entry_t> { }.swap( found );
+        }
+        std::sort( m_memory.begin( ), m_memory.end( ) );
+        m_entries = m_memory.data( );
+        m_size    = m_memory.size( );
+        return true;
+      }
+
+      for ( auto & found : entries )
+        if ( !found.empty( ) )
+          spill( found );
+
+      const bool merged = !failed.load( ) && merge( spill_fd, runs, spilled, directory );
+      if ( spill_fd >= 0 )
+        close( spill_fd );
+#ifdef TRICKSTER_DEBUG
+      if ( !merged ) {
+        _internal::log<_internal::log_levels_t::error>(
+            tr_string( "Could not write pointer map to %s. errno: %i (%s)" ),
+            directory.c_str( ),
+            errno,
+            strerror( errno ) );
+      }
+#endif
+      return merged;
+    }
+
+    /**
+     * Get entries pointing into address range.
+     * @param low lowest target address.
+     * @param high highest target address (inclusive).
+     * @return range of entries sorted by target.
+     */
+    [[nodiscard]] std::pair<const entry_t *, const entry_t *> pointing_into( std::uint64_t low,
+                                                                             std::uint64_t high ) const {
+      const auto first = std::lower_bound( begin( ), end( ), entry_t { low, 0 } );
+      const auto last  = std::upper_bound( first, end( ), entry_t { high, UINT64_MAX } );
+      return { first, last };
+    }
+
+    [[nodiscard]] const entry_t * begin( ) const noexcept { return m_entries; }
+    [[nodiscard]] const entry_t * end( ) const noexcept { return m_entries + m_size; }
+
+    /**
+     * Get number of pointers in the map.
+     * @return number of entries.
+     */
+    [[nodiscard]] std::size_t size( ) const noexcept { return m_size; }
+
+    /**
+     * Check if map is backed by a memory mapped file.
+     * @return state of statement above.
+     */
+    [[nodiscard]] bool is_file_backed( ) const noexcept { return m_mapping != nullptr; }
+  };
+
+  /**
+   * Static pointer path, resolves to the target with
+   * to_chain( module base ) passed to process_t::resolve_pointer_chains.
+   */
+  struct pointer_path_t {
+    /**
+     * Filename of the module holding the static pointer.
+     */
+    std::string module;
+
+    /**
+     * Offset of the static pointer from the module base, followed by offsets
+     * added after every dereference.
+     */
+    std::vector<std::ptrdiff_t> offsets;
+
+    /**
+     * Get pointer chain of the path.
+     * @param module_base base address of the module in the process.
+     * @return pointer chain.
+     */
+    [[nodiscard]] pointer_chain_t to_chain( std::uintptr_t module_base ) const {
+      return { module_base, offsets };
+    }
+  };
+
+  /**
+   * Pointer scanner, finds paths from static module data to dynamic addresses.
+   * Reverse pointer map is built once and searched breadth first from the
+   * target, so the shortest paths are found first.
+   */
+  class pointer_scanner_t {
+  private:
+    struct node_t {
+      std::uint64_t address;
+      std::uint32_t parent, offset;
+    };
+
+    constexpr static std::uint32_t root = UINT32_MAX;
+
+    const process_t &      m_process;
+    pointer_scan_options_t m_options;
+    pointer_map_t          m_map;
+
+    /**
+     * Get module whose static data contains address. Anonymous region right
+     * after a file backed one is treated as its .bss.
+     */
+    [[nodiscard]] const module_t * static_module( std::uintptr_t address ) const {
+      const auto & regions = m_process.get_memory_regions( );
+      const auto   index   = m_process.get_region_index( ).find( address );
+      if ( index == region_index_t::npos )
+        return nullptr;
+
+      const auto * region = &regions[ index ];
+      if ( region->inode == 0 && region->path.empty( ) && index > 0 && regions[ index - 1 ].inode != 0 &&
+           regions[ index - 1 ].end == region->start )
+        region = &regions[ index - 1 ];
+      if ( region->inode == 0 || region->special )
+        return nullptr;
+      return m_process.find_module( region->path.native( ) );
+    }
+
+  public:
+    /**
+     * Create pointer scanner.
+     * @param process process to scan, its regions have to be mapped before the map is built.
+     * @param options scan options.
+     */
+    explicit pointer_scanner_t( const process_t & process, const pointer_scan_options_t & options = { } )
+        : m_process( process ), m_options( options ) {
+      tr_assert( m_options.max_offset <= UINT32_MAX, tr_string( "Maximum offset exceeds 4 GiB." ) );
+      tr_assert( m_options.chunk_size % sizeof( std::uint64_t ) == 0,
+                 tr_string( "Chunk size is not aligned." ) );
+    }
+
+    /**
+     * Build reverse pointer map of the process, has to be called before searching.
+     * @return true if map was built, false otherwise.
+     */
+    bool build_map( ) { return m_map.build( m_process, m_options ); }
+
+    /**
+     * Get reverse pointer map.
+     * @return pointer map built by build_map.
+     */
+    [[nodiscard]] const pointer_map_t & get_map( ) const noexcept { return m_map; }
+
+    /**
+     * Find static paths to target address, up to options.max_depth dereferences.
+     * @param target address to find paths to.
+     * @return paths ordered by depth.
+     */
+    [[nodiscard]] std::vector<pointer_path_t> find_paths( std::uintptr_t target ) const {
+      auto & threads = m_options.pool ? *m_options.pool : thread_pool_t::shared( );
+
+      std::vector<node_t>                      nodes { { target, root, 0 } };
+      std::unordered_set<std::uint64_t>        visited { target };
+      std::vector<pointer_path_t>              paths;
+      std::vector<std::vector<node_t>>         children( threads.size( ) );
+      std::vector<std::vector<pointer_path_t>> found( threads.size( ) );
+
+      std::size_t first = 0, last = 1;
+      for ( std::size_t depth = 1; depth <= m_options.max_depth && first < last; depth++ ) {
+        threads.parallel_for( last - first, [ & ]( std::size_t index, std::size_t worker ) {
+          const auto   parent = first + index;
+          const auto & node   = nodes[ parent ];
+          const auto   low    = node.address > m_options.max_offset ? node.address - m_options.max_offset : 0;
+          const auto [ begin, end ] = m_map.pointing_into( low, node.address );
+
+          for ( auto entry = begin; entry != end; entry++ ) {
+            const auto offset = static_cast<std::uint32_t>( node.address - entry->target );
+            const auto module = static_module( entry->source );
+            if ( !module ) {
+              children[ worker ].push_back( { entry->source, static_cast<std::uint32_t>( parent ), offset } );
+              continue;
+            }
+
+            pointer_path_t path;
+            path.module = module->name;
+            path.offsets.push_back( static_cast<std::ptrdiff_t>( entry->source - module->base ) );
+            path.offsets.push_back( offset );
+            for ( auto step = &node; step->parent != root; step = &nodes[ step->parent ] )
+              path.offsets.push_back( step->offset );
+            found[ worker ].push_back( std::move( path ) );
+          }
+        } );
+
+        for ( auto & level : found ) {
+          for ( auto & path : level ) {
+            if ( m_options.max_results != 0 && paths.size( ) == m_options.max_results )
+              return paths;
+            paths.push_back( std::move( path ) );
+          }
+          level.clear( );
+        }
+
+        // Children of the level are explored by the next one, every address once.
+        for ( auto & level : children ) {
+          for ( const auto & child : level )
+            if ( nodes.size( ) < m_options.max_nodes && visited.insert( child.address ).second )
+              nodes.push_back( child );
+          level.clear( );
+        }
+        first = last;
+        last  = nodes.size( );
+      }
+      return paths;
+    }
+  };
+
+  /**
+   * Reference scan options.
+   */
+  struct reference_scan_options_t {
+    /**
+     * Lowest and highest (inclusive) target address of kept references.
+     */
+    std::uint64_t low = 0, high = UINT64_MAX;
+
+    /**
+     * Keep only references whose target is in a mapped region, drops most
+     * of the noise decoded from data embedded in code.
+     */
+    bool mapped_only = true;
+
+    /**
+     * Size of code read at once.
+     */
+    std::size_t chunk_size = std::size_t { 4 } << 20;
+
+    /**
+     * Thread pool regions are scanned on (default: thread_pool_t::shared()).
+     */
+    thread_pool_t * pool = nullptr;
+  };
+
+  /**
+   * Reverse cross reference index of executable regions: rel32 calls and jumps
+   * and RIP-relative operands, sorted by the address they reference.
+   * Executable regions are decoded by linear sweep, one region per task of the
+   * thread pool, and read in large chunks.
+   */
+  class reference_index_t {
+  private:
+    std::vector<reference_t> m_references;
+
+    static void scan_region( const process_t &                process,
+                             const memory_region_t &          region,
+                             const reference_scan_options_t & options,
+                             std::vector<std::uint8_t> &      buffer,
+                             std::vector<reference_t> &       found ) {
+      constexpr std::size_t max_length = 15;
+      const auto &          index      = process.get_region_index( );
+
+      buffer.resize( options.chunk_size + max_length );
+      std::uint64_t base    = region.start;
+      std::size_t   carried = 0;
+      for ( auto next = region.start; next < region.end; ) {
+        const auto   size = std::min<std::uint64_t>( options.chunk_size, region.end - next );
+        read_entry_t entry { next, buffer.data( ) + carried, size };
+        std::size_t  bytes_read = 0;
+        if ( !process.read_scatter( &entry, 1, &bytes_read ).has_value( ) )
+          return;
+
+        // Instructions crossing the end of the chunk are decoded with the next one.
+        const bool  last      = bytes_read < size || next + size >= region.end;
+        const auto  available = carried + bytes_read;
+        std::size_t offset    = 0;
+        while ( offset < available && ( last || available - offset >= max_length ) ) {
+          const auto code        = buffer.data( ) + offset;
+          const auto instruction = _internal::decode_x86_64( code, available - offset );
+          if ( instruction.length == 0 ) {
+            offset++;
+            continue;
+          }
+
+          const auto reference = _internal::reference_of( instruction, code, base + offset );
+          if ( reference.has_value( ) && reference->target >= options.low &&
+               reference->target <= options.high &&
+               ( !options.mapped_only || index.find( reference->target ) != region_index_t::npos ) )
+            found.push_back( *reference );
+          offset += instruction.length;
+        }
+        if ( last )
+          return;
+
+        carried = available - offset;
+        std::memmove( buffer.data( ), buffer.data( ) + offset, carried );
+        next += size;
+        base = next - carried;
+      }
+    }
+
+  public:
+    /**
+     * Build index of the process, discarding previous contents.
+     * @param process process to scan, its regions have to be mapped.
+     * @param options scan options.
+     */
+    void build( const process_t & process, const reference_scan_options_t & options = { } ) {
+      m_references.clear( );
+
+      std::vector<const memory_region_t *> regions;
+      for ( const auto & region : process.get_memory_regions( ) )
+        if ( region.readable && region.executable )
+          regions.push_back( &region );
+
+      auto & threads = options.pool ? *options.pool : thread_pool_t::shared( );
+      std::vector<std::vector<std::uint8_t>> buffers( threads.size( ) );
+      std::vector<std::vector<reference_t>>  found( regions.size( ) );
+      threads.parallel_for( regions.size( ), [ & ]( std::size_t region, std::size_t worker ) {
+        scan_region( process, *regions[ region ], options, buffers[ worker ], found[ region ] );
+      } );
+
+      std::size_t total = 0;
+      for ( const auto & references : found )
+        total += references.size( );
+      m_references.reserve( total );
+      for ( const auto & references : found )
+        m_references.insert( m_references.end( ), references.begin( ), references.end( ) );
+      std::sort( m_references.begin( ), m_references.end( ) );
+    }
+
+    /**
+     * Get references to address.
+     * @param target referenced address.
+     * @return range of references sorted by site.
+     */
+    [[nodiscard]] std::pair<const reference_t *, const reference_t *> find( std::uint64_t target ) const {
+      return referencing( target, target );
+    }
+
+    /**
+     * Get references into address range.
+     * @param low lowest target address.
+     * @param high highest target address (inclusive).
+     * @return range of references sorted by target.
+     */
+    [[nodiscard]] std::pair<const reference_t *, const reference_t *>
+    referencing( std::uint64_t low, std::uint64_t high ) const {
+      const auto first = std::lower_bound( begin( ), end( ), reference_t { low, 0, { } } );
+      const auto last  = std::upper_bound( first, end( ), reference_t { high, UINT64_MAX, { } } );
+      return { first, last };
+    }
+
+    [[nodiscard]] const reference_t * begin( ) const noexcept { return m_references.data( ); }
+    [[nodiscard]] const reference_t * end( ) const noexcept { return begin( ) + m_references.size( ); }
+    [[nodiscard]] std::size_t         size( ) const noexcept { return m_references.size( ); }
+  };
+
+  /**
+   * Change of watched entry. Values point into the watcher arena and are valid
+   * only during the callback.
+   */
+  struct watch_change_t {
+    std::size_t    id;
+    std::uintptr_t address;
+    std::size_t    size;
+    const void *   previous;
+    const void *   current;
+  };
+
+  /**
+   * Watcher options.
+   */
+  struct watcher_options_t {
+    /**
+     * Entries separated by at most this many bytes are read as one range.
+     */
+    std::size_t run_gap = 64;
+
+    /**
+     * Queue changes for drain in addition to invoking callbacks.
+     */
+    bool queue = false;
+
+    /**
+     * Maximum number of queued changes, further changes are dropped until drained.
+     */
+    std::size_t queue_limit = 1 << 16;
+  };
+
+  /**
+   * Polls watched ranges and reports the ones that changed since the previous poll.
+   * All ranges are read with one batched read into one half of a double buffered
+   * arena and compared with the other half, first per merged range and then per
+   * entry, so poll costs one batch (IOV_MAX ranges per syscall) regardless of the
+   * number of entries. Entries can be added and removed at any time, they take
+   * effect on the next poll, which reads a new baseline without reporting changes.
+   */
+  class watcher_t {
+  public:
+    using callback_t = std::function<void( const watch_change_t & )>;
+
+  private:
+    struct registration_t {
+      std::size_t    id;
+      std::uintptr_t address;
+      std::size_t    size;
+      callback_t     callback;
+    };
+
+    struct entry_t {
+      std::size_t run, offset;
+    };
+
+    const process_t & m_process;
+    watcher_options_t m_options;
+
+    std::mutex                  m_registry_mutex;
+    std::vector<registration_t> m_registry;
+    std::size_t                 m_next_id = 0;
+    bool                        m_dirty   = false;
+
+    // Layout used by poll, rebuilt from the registry when it changed.
+    std::vector<registration_t> m_watched;
+    std::vector<entry_t>        m_entries;
+    std::vector<read_entry_t>   m_runs;
+    std::vector<std::size_t>    m_run_offsets;
+    std::vector<std::size_t>    m_bytes_read[ 2 ];
+    std::vector<read_entry_t>   m_reads;
+    std::vector<std::size_t>    m_read_runs, m_read_bytes;
+    std::vector<std::uint8_t>   m_arena;
+    std::size_t                 m_arena_size = 0;
+    std::size_t                 m_current    = 0;
+    bool                        m_baseline   = false;
+
+    // Queued values are stored in m_queue_data, previous and current pointers are set by drain.
+    std::mutex                  m_queue_mutex;
+    std::vector<watch_change_t> m_queue;
+    std::vector<std::uint8_t>   m_queue_data;
+    std::size_t                 m_dropped = 0;
+
+    std::thread             m_thread;
+    std::mutex              m_thread_mutex;
+    std::condition_variable m_thread_signal;
+    bool                    m_stop = false;
+
+    void rebuild( ) {
+      {
+        std::lock_guard<std::mutex> lock( m_registry_mutex );
+        m_watched = m_registry;
+        m_dirty   = false;
+      }
+      std::sort( m_watched.begin( ), m_watched.end( ), []( const auto & lhs, const auto & rhs ) {
+        return lhs.address < rhs.address;
+      } );
+
+      m_entries.clear( );
+      m_runs.clear( );
+      m_run_offsets.clear( );
+      m_arena_size = 0;
+      for ( const auto & watched : m_watched ) {
+        const auto end = watched.address + watched.size;
+        const auto run_end = m_runs.empty( ) ? 0 : m_runs.back( ).address + m_runs.back( ).size;
+        if ( m_runs.empty( ) || watched.address > run_end + m_options.run_gap ) {
+          m_runs.push_back( { watched.address, nullptr, watched.size } );
+          m_run_offsets.push_back( m_arena_size );
+          m_arena_size += watched.size;
+        } else if ( end > run_end ) {
+          m_runs.back( ).size += end - run_end;
+          m_arena_size += end - run_end;
+        }
+        m_entries.push_back( { m_runs.size( ) - 1, watched.address - m_runs.back( ).address } );
+      }
+
+      m_arena.resize( 2 * m_arena_size );
+      m_bytes_read[ 0 ].assign( m_runs.size( ), 0 );
+      m_bytes_read[ 1 ].assign( m_runs.size( ), 0 );
+      m_baseline = false;
+    }
+
+    void enqueue( const watch_change_t & change ) {
+      std::lock_guard<std::mutex> lock( m_queue_mutex );
+      if ( m_queue.size( ) >= m_options.queue_limit ) {
+        m_dropped++;
+        return;
+      }
+      const auto previous = static_cast<const std::uint8_t *>( change.previous );
+      const auto current  = static_cast<const std::uint8_t *>( change.current );
+      m_queue.push_back( { change.id, change.address, change.size, nullptr, nullptr } );
+      m_queue_data.insert( m_queue_data.end( ), previous, previous + change.size );
+      m_queue_data.insert( m_queue_data.end( ), current, current + change.size );
+    }
+
+  public:
+    /**
+     * Create watcher.
+     * @param process process to watch.
+     * @param options watcher options.
+     */
+    explicit watcher_t( const process_t & process, const watcher_options_t & options = { } )
+        : m_process( process ), m_options( options ) { }
+
+    watcher_t( const watcher_t & )             = delete;
+    watcher_t & operator=( const watcher_t & ) = delete;
+
+    ~watcher_t( ) { stop( ); }
+
+    /**
+     * Watch range of memory.
+     * @param address starting address.
+     * @param size size of the range.
+     * @param callback invoked from poll with the change, can be empty.
+     * @return id of the entry.
+     */
+    std::size_t add( std::uintptr_t address, std::size_t size, callback_t callback = { } ) {
+      std::lock_guard<std::mutex> lock( m_registry_mutex );
+      m_registry.push_back( { m_next_id, address, size, std::move( callback ) } );
+      m_dirty = true;
+      return m_next_id++;
+    }
+
+    /**
+     * Watch value.
+     * @param address address of the value.
+     * @param callback invoked from poll with address, previous and current value.
+     * @return id of the entry.
+     */
+    template <typename T, typename F> std::size_t add( std::uintptr_t address, F && callback ) {
+      static_assert( std::is_trivially_copyable_v<T>, "Watched type has to be trivially copyable." );
+      return add( address,
+                  sizeof( T ),
+                  [ callback = std::forward<F>( callback ) ]( const watch_change_t & change ) {
+                    T previous, current;
+                    std::memcpy( &previous, change.previous, sizeof( T ) );
+                    std::memcpy( &current, change.current, sizeof( T ) );
+                    callback( change.address, previous, current );
+                  } );
+    }
+
+    /**
+     * Stop watching entry.
+     * @param id id returned by add.
+     * @return true if entry was watched, false otherwise.
+     */
+    bool remove( std::size_t id ) {
+      std::lock_guard<std::mutex> lock( m_registry_mutex );
+      const auto                  entry =
+          std::find_if( m_registry.begin( ), m_registry.end( ), [ id ]( const registration_t & watched ) {
+            return watched.id == id;
+          } );
+      if ( entry == m_registry.end( ) )
+        return false;
+      m_registry.erase( entry );
+      m_dirty = true;
+      return true;
+    }
+
+    /**
+     * Read all entries and report the ones that changed. Entries that could not
+     * be read now or by the previous poll are not reported. Must not be called
+     * concurrently, also not while the polling thread runs.
+     * @param dirty optional sorted ranges written since the previous poll, e.g.
+     * collected by dirty_tracker_t. Runs outside them are not read and keep
+     * their previous contents. Ignored by the poll reading a new baseline.
+     * @return number of changed entries or std::nullopt if process memory cannot be accessed.
+     */
+    std::optional<std::size_t> poll( const std::vector<page_range_t> * dirty = nullptr ) {
+      bool registry_changed;
+      {
+        std::lock_guard<std::mutex> lock( m_registry_mutex );
+        registry_changed = m_dirty;
+      }
+      if ( registry_changed )
+        rebuild( );
+
+      const auto current  = m_current;
+      const auto previous = current ^ 1;
+      const auto arena    = m_arena.data( ) + current * m_arena_size;
+      const auto old      = m_arena.data( ) + previous * m_arena_size;
+
+      for ( std::size_t run = 0; run < m_runs.size( ); run++ )
+        m_runs[ run ].buffer = arena + m_run_offsets[ run ];
+      auto &       bytes_read     = m_bytes_read[ current ];
+      const auto & previous_bytes = m_bytes_read[ previous ];
+      if ( !dirty || !m_baseline ) {
+        if ( !m_process.read_scatter( m_runs.data( ), m_runs.size( ), bytes_read.data( ) ) )
+          return std::nullopt;
+      } else {
+        m_reads.clear( );
+        m_read_runs.clear( );
+        for ( std::size_t run = 0; run < m_runs.size( ); run++ ) {
+          const auto & entry = m_runs[ run ];
+          if ( _internal::intersects( *dirty, entry.address, entry.address + entry.size ) ) {
+            m_reads.push_back( entry );
+            m_read_runs.push_back( run );
+            continue;
+          }
+          std::memcpy( arena + m_run_offsets[ run ], old + m_run_offsets[ run ], entry.size );
+          bytes_read[ run ] = previous_bytes[ run ];
+        }
+
+        m_read_bytes.resize( m_reads.size( ) );
+        if ( !m_process.read_scatter( m_reads.data( ), m_reads.size( ), m_read_bytes.data( ) ) )
+          return std::nullopt;
+        for ( std::size_t read = 0; read < m_reads.size( ); read++ )
+          bytes_read[ m_read_runs[ read ] ] = m_read_bytes[ read ];
+      }
+
+      m_current = previous;
+      if ( !m_baseline ) {
+        m_baseline = true;
+        return 0;
+      }
+
+      std::size_t changes = 0;
+      for ( std::size_t i = 0, run = 0; i < m_entries.size( ); ) {
+        // Equal runs are skipped as a whole, memcmp does the wide comparison.
+        const auto offset = m_run_offsets[ run ];
+        const auto size   = m_runs[ run ].size;
+        if ( bytes_read[ run ] == size && previous_bytes[ run ] == size &&
+             std::memcmp( arena + offset, old + offset, size ) == 0 ) {
+          for ( ; i < m_entries.size( ) && m_entries[ i ].run == run; i++ ) { }
+          run++;
+          continue;
+        }
+
+        for ( ; i < m_entries.size( ) && m_entries[ i ].run == run; i++ ) {
+          const auto & entry   = m_entries[ i ];
+          const auto & watched = m_watched[ i ];
+          const auto   end     = entry.offset + watched.size;
+          if ( end > bytes_read[ run ] || end > previous_bytes[ run ] ||
+               std::memcmp( arena + offset + entry.offset, old + offset + entry.offset, watched.size ) == 0 )
+            continue;
+
+          const auto           before = old + offset + entry.offset;
+          const auto           after  = arena + offset + entry.offset;
+          const watch_change_t change { watched.id, watched.address, watched.size, before, after };
+          if ( watched.callback )
+            watched.callback( change );
+          if ( m_options.queue )
+            enqueue( change );
+          changes++;
+        }
+        run++;
+      }
+      return changes;
+    }
+
+    /**
+     * Invoke callback for every queued change and clear the queue.
+     * @param callback invoked with the change, values are valid only during the call.
+     * @return number of drained changes.
+     */
+    template <typename F> std::size_t drain( F && callback ) {
+      std::vector<watch_change_t> changes;
+      std::vector<std::uint8_t>   data;
+      {
+        std::lock_guard<std::mutex> lock( m_queue_mutex );
+        changes.swap( m_queue );
+        data.swap( m_queue_data );
+      }
+
+      std::size_t position = 0;
+      for ( auto & change : changes ) {
+        change.previous = data.data( ) + position;
+        change.current  = data.data( ) + position + change.size;
+        position += 2 * change.size;
+        callback( std::as_const( change ) );
+      }
+      return changes.size( );
+    }
+
+    /**
+     * Get number of changes dropped because the queue was full.
+     * @return number of dropped changes.
+     */
+    [[nodiscard]] std::size_t dropped( ) {
+      std::lock_guard<std::mutex> lock( m_queue_mutex );
+      return m_dropped;
+    }
+
+    /**
+     * Start polling on a background thread, callbacks are invoked on it.
+     * @param interval time between the starts of two polls.
+     */
+    void start( std::chrono::microseconds interval ) {
+      stop( );
+      m_stop   = false;
+      m_thread = std::thread( [ this, interval ] {
+        auto                         next = std::chrono::steady_clock::now( );
+        std::unique_lock<std::mutex> lock( m_thread_mutex );
+        while ( !m_stop ) {
+          lock.unlock( );
+          (void)poll( );
+          lock.lock( );
+
+          next += interval;
+          if ( std::chrono::steady_clock::now( ) > next )
+            next = std::chrono::steady_clock::now( ); // overran, do not try to catch up
+          m_thread_signal.wait_until( lock, next, [ this ] { return m_stop; } );
+        }
+      } );
+    }
+
+    /**
+     * Stop polling thread, waits for the running poll to finish.
+     */
+    void stop( ) {
+      if ( !m_thread.joinable( ) )
+        return;
+      {
+        std::lock_guard<std::mutex> lock( m_thread_mutex );
+        m_stop = true;
+      }
+      m_thread_signal.notify_all( );
+      m_thread.join( );
+    }
+
+    /**
+     * Get number of watched entries.
+     * @return number of entries.
+     */
+    [[nodiscard]] std::size_t size( ) {
+      std::lock_guard<std::mutex> lock( m_registry_mutex );
+      return m_registry.size( );
+    }
+  };
+
+  /**
+   * Freezer options.
+   */
+  struct freezer_options_t {
+    /**
+     * Time between the starts of two rewrites.
+     */
+    std::chrono::microseconds interval { 1000 };
+
+    /**
+     * Read entries before writing and write only the ones whose value diverged.
+     */
+    bool verify = false;
+
+    /**
+     * Busy wait this long before every rewrite instead of sleeping, trades
+     * CPU time for lower wake up jitter.
+     */
+    std::chrono::microseconds spin { 0 };
+  };
+
+  /**
+   * Timing and traffic statistics of freezer_t.
+   */
+  struct freezer_stats_t {
+    /**
+     * Number of rewrite cycles, batched writes issued and bytes written.
+     */
+    std::uint64_t ticks, writes, bytes_written;
+    /**
+     * Entries found diverged by verification and entries that could not be written.
+     */
+    std::uint64_t divergences, failures;
+    /**
+     * Mean and maximum delay of cycle start after its scheduled time.
+     */
+    std::chrono::nanoseconds jitter_mean, jitter_max;
+    /**
+     * Batched writes per second since start.
+     */
+    double writes_per_second;
+  };
+
+  /**
+   * Keeps values frozen by rewriting them from a dedicated thread at fixed
+   * rate, all entries coalesced into one batched write. Entries are registered
+   * through a lock-free list, so add and remove never block on the writer
+   * thread and can be called from any thread.
+   */
+  class freezer_t {
+  private:
+    struct command_t {
+      command_t *               next;
+      std::size_t               id;
+      std::uintptr_t            address;
+      std::vector<std::uint8_t> bytes;
+      bool                      remove;
+    };
+
+    struct entry_t {
+      std::size_t    id;
+      std::uintptr_t address;
+      std::size_t    offset, size;
+    };
+
+    const process_t &        m_process;
+    freezer_options_t        m_options;
+    std::atomic<command_t *> m_commands { nullptr };
+    std::atomic<std::size_t> m_next_id { 0 };
+
+    // Writer side state.
+    std::vector<entry_t>      m_entries;
+    std::vector<std::uint8_t> m_values, m_current;
+    std::vector<read_entry_t> m_reads;
+    std::vector<std::size_t>  m_bytes_read;
+    write_batch_t             m_batch, m_diverged;
+
+    std::thread             m_thread;
+    std::mutex              m_thread_mutex;
+    std::condition_variable m_thread_signal;
+    std::atomic<bool>       m_stop { true };
+
+    std::atomic<std::uint64_t> m_ticks { 0 }, m_writes { 0 }, m_bytes_written { 0 };
+    std::atomic<std::uint64_t> m_divergences { 0 }, m_failures { 0 };
+    std::atomic<std::uint64_t> m_jitter_sum { 0 }, m_jitter_max { 0 };
+    std::atomic<std::int64_t>  m_started { 0 };
+
+    void push( command_t * command ) {
+      command->next = m_commands.load( std::memory_order_relaxed );
+      while ( !m_commands.compare_exchange_weak(
+          command->next, command, std::memory_order_release, std::memory_order_relaxed ) ) {
+      }
+    }
+
+    /**
+     * Apply queued commands in order they were pushed.
+     * @return true if entries changed.
+     */
+    bool apply_commands( ) {
+      command_t * command = m_commands.exchange( nullptr, std::memory_order_acquire );
+      if ( !command )
+        return false;
+
+      command_t * ordered = nullptr;
+      while ( command ) {
+        const auto next = command->next;
+        command->next   = ordered;
+        ordered         = command;
+        command         = next;
+      }
+
+      for ( ; ordered; ) {
+        const std::unique_ptr<command_t> current( ordered );
+        ordered = ordered->next;
+
+        const auto id    = current->id;
+        const auto matches = [ id ]( const entry_t & entry ) { return entry.id == id; };
+        const auto entry   = std::find_if( m_entries.begin( ), m_entries.end( ), matches );
+        if ( entry != m_entries.end( ) )
+          m_entries.erase( entry );
+        if ( current->remove )
+          continue;
+
+        m_entries.push_back( { current->id, current->address, m_values.size( ), current->bytes.size( ) } );
+        m_values.insert( m_values.end( ), current->bytes.begin( ), current->bytes.end( ) );
+      }
+
+      // Compact values of removed entries and rebuild the batch.
+      std::vector<std::uint8_t> values;
+      m_batch.clear( );
+      for ( auto & entry : m_entries ) {
+        const auto offset = values.size( );
+        const auto first  = m_values.begin( ) + static_cast<std::ptrdiff_t>( entry.offset );
+        values.insert( values.end( ), first, first + static_cast<std::ptrdiff_t>( entry.size ) );
+        entry.offset = offset;
+        m_batch.add_bytes( entry.address, values.data( ) + offset, entry.size );
+      }
+      m_values = std::move( values );
+      m_current.resize( m_values.size( ) );
+      return true;
+    }
+
+    void record( const std::optional<std::vector<_internal::write_result_t<void>>> & results,
+                 std::size_t                                                         count ) {
+      m_writes.fetch_add( 1, std::memory_order_relaxed );
+      if ( !results.has_value( ) ) {
+        m_failures.fetch_add( count, std::memory_order_relaxed );
+        return;
+      }
+
+      std::uint64_t written = 0, failed = 0;
+      for ( const auto & result : *results ) {
+        written += result.bytes_written;
+        failed += result.partial_write;
+      }
+      m_bytes_written.fetch_add( written, std::memory_order_relaxed );
+      m_failures.fetch_add( failed, std::memory_order_relaxed );
+    }
+
+  public:
+    /**
+     * Create freezer, rewrites need to be started with start().
+     * @param process process to write to.
+     * @param options freezer options.
+     */
+    explicit freezer_t( const process_t & process, const freezer_options_t & options = { } )
+        : m_process( process ), m_options( options ) { }
+
+    ~freezer_t( ) {
+      stop( );
+      for ( auto command = m_commands.exchange( nullptr ); command; ) {
+        const auto next = command->next;
+        delete command;
+        command = next;
+      }
+    }
+
+    freezer_t( const freezer_t & )             = delete;
+    freezer_t & operator=( const freezer_t & ) = delete;
+
+    /**
+     * Freeze raw bytes at address.
+     * @param address address of the value.
+     * @param data bytes to be kept, copied.
+     * @param size number of bytes.
+     * @return id of the entry.
+     */
+    std::size_t add_bytes( std::uintptr_t address, const void * data, std::size_t size ) {
+      const auto id    = m_next_id.fetch_add( 1, std::memory_order_relaxed );
+      const auto bytes = static_cast<const std::uint8_t *>( data );
+      push( new command_t { nullptr, id, address, { bytes, bytes + size }, false } );
+      return id;
+    }
+
+    /**
+     * Freeze value at address.
+     * @param address address of the value.
+     * @param value value to be kept.
+     * @return id of the entry.
+     */
+    template <typename T> std::size_t add( std::uintptr_t address, const T & value ) {
+      static_assert( std::is_trivially_copyable_v<T>, "Frozen value requires trivially copyable type." );
+      return add_bytes( address, std::addressof( value ), sizeof( T ) );
+    }
+
+    /**
+     * Change value of a frozen entry.
+     * @param id id of the entry.
+     * @param address address of the value.
+     * @param value new value to be kept.
+     */
+    template <typename T> void set( std::size_t id, std::uintptr_t address, const T & value ) {
+      static_assert( std::is_trivially_copyable_v<T>, "Frozen value requires trivially copyable type." );
+      const auto bytes = reinterpret_cast<const std::uint8_t *>( std::addressof( value ) );
+      push( new command_t { nullptr, id, address, { bytes, bytes + sizeof( T ) }, false } );
+    }
+
+    /**
+     * Stop keeping entry, takes effect with the next rewrite.
+     * @param id id of the entry.
+     */
+    void remove( std::size_t id ) { push( new command_t { nullptr, id, 0, { }, true } ); }
+
+    /**
+     * Apply pending registrations and rewrite all entries once, or with
+     * options.verify only the diverged ones. Called by the writer thread, must
+     * not be called while it runs.
+     * @return number of entries written.
+     */
+    std::size_t tick( ) {
+      apply_commands( );
+      m_ticks.fetch_add( 1, std::memory_order_relaxed );
+      if ( m_entries.empty( ) )
+        return 0;
+
+      if ( !m_options.verify ) {
+        record( m_process.write_batch( m_batch ), m_batch.size( ) );
+        return m_entries.size( );
+      }
+
+      m_reads.resize( m_entries.size( ) );
+      m_bytes_read.assign( m_entries.size( ), 0 );
+      for ( std::size_t i = 0; i < m_entries.size( ); i++ ) {
+        const auto & entry = m_entries[ i ];
+        m_reads[ i ]       = { entry.address, m_current.data( ) + entry.offset, entry.size };
+      }
+      (void)m_process.read_scatter( m_reads.data( ), m_reads.size( ), m_bytes_read.data( ) );
+
+      m_diverged.clear( );
+      for ( std::size_t i = 0; i < m_entries.size( ); i++ ) {
+        const auto & entry = m_entries[ i ];
+        const auto   value = m_values.data( ) + entry.offset;
+        const auto   read  = m_current.data( ) + entry.offset;
+        if ( m_bytes_read[ i ] == entry.size && std::memcmp( read, value, entry.size ) == 0 )
+          continue;
+        m_diverged.add_bytes( entry.address, value, entry.size );
+      }
+      if ( m_diverged.empty( ) )
+        return 0;
+
+      m_divergences.fetch_add( m_diverged.size( ), std::memory_order_relaxed );
+      record( m_process.write_batch( m_diverged ), m_diverged.size( ) );
+      return m_diverged.size( );
+    }
+
+    /**
+     * Start rewriting on the writer thread.
+     */
+    void start( ) {
+      stop( );
+      m_stop.store( false );
+      m_started.store( std::chrono::steady_clock::now( ).time_since_epoch( ).count( ) );
+      m_thread = std::thread( [ this ] {
+        using clock = std::chrono::steady_clock;
+        auto next   = clock::now( );
+        while ( !m_stop.load( std::memory_order_relaxed ) ) {
+          const auto jitter = static_cast<std::uint64_t>(
+              std::max<std::int64_t>( ( clock::now( ) - next ).count( ), 0 ) );
+          m_jitter_sum.fetch_add( jitter, std::memory_order_relaxed );
+          if ( jitter > m_jitter_max.load( std::memory_order_relaxed ) )
+            m_jitter_max.store( jitter, std::memory_order_relaxed );
+
+          tick( );
+
+          next += m_options.interval;
+          if ( clock::now( ) > next )
+            next = clock::now( ); // overran, do not try to catch up
+          {
+            std::unique_lock<std::mutex> lock( m_thread_mutex );
+            m_thread_signal.wait_until( lock, next - m_options.spin, [ this ] { return m_stop.load( ); } );
+          }
+          while ( clock::now( ) < next && !m_stop.load( std::memory_order_relaxed ) ) {
+          }
+        }
+      } );
+    }
+
+    /**
+     * Stop writer thread, waits for the running rewrite to finish.
+     */
+    void stop( ) {
+      if ( !m_thread.joinable( ) )
+        return;
+      {
+        std::lock_guard<std::mutex> lock( m_thread_mutex );
+        m_stop.store( true );
+      }
+      m_thread_signal.notify_all( );
+      m_thread.join( );
+    }
+
+    /**
+     * Check if writer thread runs.
+     * @return state of statement above.
+     */
+    [[nodiscard]] bool running( ) const noexcept { return !m_stop.load( ); }
+
+    /**
+     * Get statistics since construction, rate since the last start.
+     * @return statistics.
+     */
+    [[nodiscard]] freezer_stats_t stats( ) const {
+      freezer_stats_t stats;
+      stats.ticks         = m_ticks.load( std::memory_order_relaxed );
+      stats.writes        = m_writes.load( std::memory_order_relaxed );
+      stats.bytes_written = m_bytes_written.load( std::memory_order_relaxed );
+      stats.divergences   = m_divergences.load( std::memory_order_relaxed );
+      stats.failures      = m_failures.load( std::memory_order_relaxed );
+      stats.jitter_mean   = std::chrono::nanoseconds(
+          stats.ticks ? m_jitter_sum.load( std::memory_order_relaxed ) / stats.ticks : 0 );
+      stats.jitter_max = std::chrono::nanoseconds( m_jitter_max.load( std::memory_order_relaxed ) );
+
+      const auto elapsed = std::chrono::duration<double>(
+          std::chrono::steady_clock::now( ).time_since_epoch( ) -
+          std::chrono::steady_clock::duration( m_started.load( std::memory_order_relaxed ) ) );
+      stats.writes_per_second =
+          elapsed.count( ) > 0 ? static_cast<double>( stats.writes ) / elapsed.count( ) : 0;
+      return stats;
+    }
+  };
+
+  /**
+   * Soft-dirty page tracking. reset() clears soft-dirty bits of all pages of the
+   * process, collect() reads /proc/$PID/pagemap for the mapped regions and
+   * returns pages written since. Requires kernel with CONFIG_MEM_SOFT_DIRTY
+   * and permission to ptrace the process.
+   */
+  class dirty_tracker_t {
+  private:
+    // Pagemap entries read at once.
+    constexpr static std::size_t batch = 1 << 14;
+
+    const process_t &          m_process;
+    const int                  m_pagemap_fd;
+    std::vector<std::uint64_t> m_entries;
+
+    /**
+     * Check for soft-dirty support, pages of a new mapping are soft-dirty
+     * unless the kernel does not track the bit at all.
+     */
+    [[nodiscard]] static bool probe( ) {
+      const auto page_size = static_cast<std::size_t>( sysconf( _SC_PAGESIZE ) );
+      const auto mapping =
+          mmap( nullptr, page_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0 );
+      if ( mapping == MAP_FAILED )
+        return false;
+      const auto page = static_cast<volatile std::uint8_t *>( mapping );
+      *page           = 1;
+
+      std::uint64_t entry = 0;
+      const int     fd    = open( tr_string( "/proc/self/pagemap" ), O_RDONLY | O_CLOEXEC );
+      if ( fd >= 0 ) {
+        const auto offset = reinterpret_cast<std::uintptr_t>( page ) / page_size * sizeof( entry );
+        if ( pread( fd, &entry, sizeof( entry ), static_cast<off_t>( offset ) ) != sizeof( entry ) )
+          entry = 0;
+        close( fd );
+      }
+      munmap( mapping, page_size );
+      return entry & _internal::pagemap_soft_dirty;
+    }
+
+  public:
+    /**
+     * Create tracker.
+     * @param process process to track, its regions have to be mapped before collect.
+     */
+    explicit dirty_tracker_t( const process_t & process )
+        : m_process( process ), m_pagemap_fd( _internal::open_pagemap( process.get_id( ) ) ) {
+#ifdef TRICKSTER_DEBUG
+      if ( m_pagemap_fd < 0 ) {
+        _internal::log<_internal::log_levels_t::error>(
+            tr_string( "Could not open pagemap of process with %i id. errno: %i (%s)" ),
+            process.get_id( ),
+            errno,
+            strerror( errno ) );
+      }
+#endif
+    }
+
+    dirty_tracker_t( const dirty_tracker_t & )             = delete;
+    dirty_tracker_t & operator=( const dirty_tracker_t & ) = delete;
+
+    ~dirty_tracker_t( ) {
+      if ( m_pagemap_fd >= 0 )
+        close( m_pagemap_fd );
+    }
+
+    /**
+     * Check if pagemap of the process is accessible.
+     * @return state of statement above.
+     */
+    [[nodiscard]] bool is_valid( ) const noexcept { return m_pagemap_fd >= 0; }
+
+    /**
+     * Check if kernel tracks soft-dirty bits (CONFIG_MEM_SOFT_DIRTY).
+     * @return state of statement above.
+     */
+    [[nodiscard]] static bool is_supported( ) {
+      static const bool supported = probe( );
+      return supported;
+    }
+
+    /**
+     * Clear soft-dirty bits, following collect reports pages written after this call.
+     * @return true if bits were cleared, false otherwise.
+     */
+    bool reset( ) const {
+      char path[ 32 ];
+      snprintf( path, sizeof( path ), tr_string( "/proc/%i/clear_refs" ), m_process.get_id( ) );
+
+      const int fd = open( path, O_WRONLY | O_CLOEXEC );
+      if ( fd < 0 ) {
+#ifdef TRICKSTER_DEBUG
+        _internal::log<_internal::log_levels_t::error>(
+            tr_string( "Could not open %s. errno: %i (%s)" ), path, errno, strerror( errno ) );
+#endif
+        return false;
+      }
+      const bool cleared = write( fd, tr_string( "4" ), 1 ) == 1;
+      close( fd );
+      return cleared;
+    }
+
+    /**
+     * Collect pages written since the last reset. Regions mapped after reset
+     * are reported dirty as a whole.
+     * @param writable_only collect only writable regions (default: true).
+     * @return sorted page ranges with adjacent pages merged, or std::nullopt
+     * if pagemap cannot be read or soft-dirty bits are not supported, in which
+     * case everything has to be treated as dirty.
+     */
+    [[nodiscard]] std::optional<std::vector<page_range_t>> collect( bool writable_only = true ) {
+      if ( m_pagemap_fd < 0 || !is_supported( ) )
+        return std::nullopt;
+
+      const auto                page_size = static_cast<std::uintptr_t>( sysconf( _SC_PAGESIZE ) );
+      std::vector<page_range_t> dirty;
+      m_entries.resize( batch );
+
+      for ( const auto & region : m_process.get_memory_regions( ) ) {
+        if ( ( writable_only && !region.writable ) || region.special )
+          continue;
+
+        for ( auto page = region.start / page_size; page < region.end / page_size; ) {
+          const auto count  = std::min<std::uintptr_t>( batch, region.end / page_size - page );
+          const auto result = pread( m_pagemap_fd,
+                                     m_entries.data( ),
+                                     count * sizeof( std::uint64_t ),
+                                     static_cast<off_t>( page * sizeof( std::uint64_t ) ) );
+          if ( result < 0 && errno == EINTR )
+            continue;
+          if ( result <= 0 )
+            return std::nullopt;
+
+          for ( std::size_t i = 0; i < static_cast<std::size_t>( result ) / sizeof( std::uint64_t ); i++ ) {
+            if ( !( m_entries[ i ] & _internal::pagemap_soft_dirty ) )
+              continue;
+            const auto address = ( page + i ) * page_size;
+            if ( !dirty.empty( ) && dirty.back( ).end == address )
+              dirty.back( ).end += page_size;
+            else
+              dirty.push_back( { address, address + page_size } );
+          }
+          page += static_cast<std::size_t>( result ) / sizeof( std::uint64_t );
+        }
+      }
+      return dirty;
+    }
+  };
+
+  /**
+   * Asynchronous read request.
+   */
+  struct async_read_t {
+    std::uintptr_t address;
+    void *         buffer;
+    std::size_t    size;
+    /**
+     * Value returned with the completion of the read.
+     */
+    std::uint64_t user_data;
+  };
+
+  /**
+   * Completion of asynchronous read.
+   */
+  struct async_completion_t {
+    std::uint64_t user_data;
+    std::size_t   bytes_read;
+    /**
+     * errno of the read, 0 if at least part of the range was read.
+     */
+    int error;
+  };
+
+  /**
+   * Mechanism async_reader_t uses to execute reads.
+   */
+  enum class async_backend_t : std::uint8_t {
+    /**
+     * IORING_OP_READ / IORING_OP_READ_FIXED on /proc/$PID/mem.
+     */
+    io_uring = 0,
+
+    /**
+     * Worker threads batching queued reads into read_scatter calls.
+     */
+    threads
+  };
+
+  /**
+   * Asynchronous reader options.
+   */
+  struct async_reader_options_t {
+    /**
+     * Maximum number of reads in flight.
+     */
+    std::size_t queue_depth = 256;
+
+    /**
+     * Number of worker threads of the thread backend.
+     */
+    std::size_t threads = 4;
+
+    /**
+     * Use io_uring when the kernel supports it.
+     */
+    bool io_uring = true;
+  };
+
+#ifdef TRICKSTER_IO_URING
+  namespace _internal {
+    /**
+     * Minimal io_uring instance driven by raw syscalls.
+     */
+    class io_uring_t {
+    private:
+      int             m_fd       = -1;
+      void *          m_sq_ring  = MAP_FAILED;
+      void *          m_cq_ring  = MAP_FAILED;
+      io_uring_sqe *  m_sqes     = static_cast<io_uring_sqe *>( MAP_FAILED );
+      std::size_t     m_sq_size  = 0, m_cq_size = 0, m_sqes_size = 0;
+      unsigned *      m_sq_head  = nullptr;
+      unsigned *      m_sq_tail  = nullptr;
+      unsigned *      m_sq_mask  = nullptr;
+      unsigned *      m_sq_array = nullptr;
+      unsigned *      m_cq_head  = nullptr;
+      unsigned *      m_cq_tail  = nullptr;
+      unsigned *      m_cq_mask  = nullptr;
+      io_uring_cqe *  m_cqes     = nullptr;
+      unsigned        m_entries  = 0, m_unsubmitted = 0;
+
+      template <typename T> T * at( void * ring, std::uint32_t offset ) const noexcept {
+        return reinterpret_cast<T *>( static_cast<std::uint8_t *>( ring ) + offset );
+      }
+
+      bool supports( std::uint8_t opcode ) const {
+        constexpr std::size_t     operations = 256;
+        std::vector<std::uint8_t> storage( sizeof( io_uring_probe ) +
+                                           operations * sizeof( io_uring_probe_op ) );
+        const auto                probe = reinterpret_cast<io_uring_probe *>( storage.data( ) );
+        if ( syscall( __NR_io_uring_register, m_fd, IORING_REGISTER_PROBE, probe, operations ) < 0 )
+          return false;
+        return opcode <= probe->last_op && ( probe->ops[ opcode ].flags & IO_URING_OP_SUPPORTED );
+      }
+
+    public:
+      io_uring_t( )                                = default;
+      io_uring_t( const io_uring_t & )             = delete;
+      io_uring_t & operator=( const io_uring_t & ) = delete;
+
+      ~io_uring_t( ) {
+        if ( m_sqes != MAP_FAILED )
+          munmap( m_sqes, m_sqes_size );
+        if ( m_cq_ring != MAP_FAILED && m_cq_ring != m_sq_ring )
+          munmap( m_cq_ring, m_cq_size );
+        if ( m_sq_ring != MAP_FAILED )
+          munmap( m_sq_ring, m_sq_size );
+        if ( m_fd >= 0 )
+          close( m_fd );
+      }
+
+      /**
+       * Create instance and map its rings.
+       * @param entries submission queue size.
+       * @return true if the kernel supports io_uring with IORING_OP_READ, false otherwise.
+       */
+      bool setup( unsigned entries ) {
+        io_uring_params params { };
+        m_fd = static_cast<int>( syscall( __NR_io_uring_setup, entries, &params ) );
+        if ( m_fd < 0 )
+          return false;
+
+        m_sq_size = params.sq_off.array + params.sq_entries * sizeof( unsigned );
+        m_cq_size = params.cq_off.cqes + params.cq_entries * sizeof( io_uring_cqe );
+        if ( params.features & IORING_FEAT_SINGLE_MMAP )
+          m_sq_size = m_cq_size = std::max( m_sq_size, m_cq_size );
+
+        m_sq_ring = mmap( nullptr, m_sq_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_fd,
+                          IORING_OFF_SQ_RING );
+        if ( m_sq_ring == MAP_FAILED )
+          return false;
+        m_cq_ring = params.features & IORING_FEAT_SINGLE_MMAP
+                        ? m_sq_ring
+                        : mmap( nullptr, m_cq_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_fd,
+                                IORING_OFF_CQ_RING );
+        if ( m_cq_ring == MAP_FAILED )
+          return false;
+        m_sqes_size = params.sq_entries * sizeof( io_uring_sqe );
+        m_sqes      = static_cast<io_uring_sqe *>( mmap( nullptr, m_sqes_size, PROT_READ | PROT_WRITE,
+                                                         MAP_SHARED | MAP_POPULATE, m_fd, IORING_OFF_SQES ) );
+        if ( m_sqes == MAP_FAILED )
+          return false;
+
+        m_sq_head  = at<unsigned>( m_sq_ring, params.sq_off.head );
+        m_sq_tail  = at<unsigned>( m_sq_ring, params.sq_off.tail );
+        m_sq_mask  = at<unsigned>( m_sq_ring, params.sq_off.ring_mask );
+        m_sq_array = at<unsigned>( m_sq_ring, params.sq_off.array );
+        m_cq_head  = at<unsigned>( m_cq_ring, params.cq_off.head );
+        m_cq_tail  = at<unsigned>( m_cq_ring, params.cq_off.tail );
+        m_cq_mask  = at<unsigned>( m_cq_ring, params.cq_off.ring_mask );
+        m_cqes     = at<io_uring_cqe>( m_cq_ring, params.cq_off.cqes );
+        m_entries  = params.sq_entries;
+        return supports( IORING_OP_READ );
+      }
+
+      /**
+       * Get submission queue size, completion queue is at least twice as big.
+       * @return number of submission queue entries.
+       */
+      [[nodiscard]] unsigned entries( ) const noexcept { return m_entries; }
+
+      /**
+       * Register fixed buffers, replacing previously registered ones.
+       * @return true if buffers were registered, false otherwise.
+       */
+      bool register_buffers( const iovec * buffers, unsigned count ) {
+        syscall( __NR_io_uring_register, m_fd, IORING_UNREGISTER_BUFFERS, nullptr, 0 );
+        return count == 0 ||
+               syscall( __NR_io_uring_register, m_fd, IORING_REGISTER_BUFFERS, buffers, count ) == 0;
+      }
+
+      /**
+       * Queue read, caller keeps number of entries in flight below entries().
+       */
+      void queue_read( int fd, const async_read_t & read, int buffer_index ) {
+        const auto tail  = *m_sq_tail + m_unsubmitted;
+        const auto index = tail & *m_sq_mask;
+        auto &     sqe   = m_sqes[ index ];
+
+        std::memset( &sqe, 0, sizeof( sqe ) );
+        sqe.opcode    = buffer_index < 0 ? IORING_OP_READ : IORING_OP_READ_FIXED;
+        sqe.fd        = fd;
+        sqe.off       = read.address;
+        sqe.addr      = reinterpret_cast<std::uintptr_t>( read.buffer );
+        sqe.len       = static_cast<std::uint32_t>( read.size );
+        sqe.buf_index = static_cast<std::uint16_t>( buffer_index < 0 ? 0 : buffer_index );
+        sqe.user_data = read.user_data;
+        m_sq_array[ index ] = index;
+        m_unsubmitted++;
+      }
+
+      /**
+       * Submit queued reads and optionally wait for completions. Entries the
+       * kernel did not consume, because io_uring_enter failed or submitted
+       * only some of them, stay in the submission queue and are submitted
+       * again by the next call.
+       * @param wait number of completions to wait for.
+       * @return false if io_uring_enter failed.
+       */
+      bool enter( unsigned wait ) {
+        const auto tail = *m_sq_tail + m_unsubmitted;
+        __atomic_store_n( m_sq_tail, tail, __ATOMIC_RELEASE );
+        m_unsubmitted      = 0;
+        const auto pending = tail - __atomic_load_n( m_sq_head, __ATOMIC_ACQUIRE );
+        if ( pending == 0 && wait == 0 )
+          return true;
+
+        for ( ;; ) {
+          const auto result = syscall( __NR_io_uring_enter, m_fd, pending, wait,
+                                       wait != 0 ? IORING_ENTER_GETEVENTS : 0, nullptr, 0 );
+          if ( result >= 0 )
+            return true;
+          if ( errno != EINTR )
+            return false;
+        }
+      }
+
+      /**
+       * Consume completions.
+       * @param callback called with every io_uring_cqe, returns false to stop.
+       */
+      template <typename F> void reap( F && callback ) {
+        auto       head = *m_cq_head;
+        const auto tail = __atomic_load_n( m_cq_tail, __ATOMIC_ACQUIRE );
+        for ( ; head != tail; head++ )
+          if ( !callback( m_cqes[ head & *m_cq_mask ] ) )
+            break;
+        __atomic_store_n( m_cq_head, head, __ATOMIC_RELEASE );
+      }
+    };
+  } // namespace _internal
+#endif
+
+  /**
+   * Asynchronous reader of process memory with submission and completion
+   * queues, for overlapping reads with processing of already read data.
+   * Reads are executed by io_uring on /proc/$PID/mem when available (reads
+   * into registered buffers use IORING_OP_READ_FIXED), otherwise by worker
+   * threads batching queued reads into read_scatter calls.
+   * Reader itself is not thread safe, one thread submits and reaps.
+   */
+  class async_reader_t {
+  private:
+    const process_t &      m_process;
+    async_reader_options_t m_options;
+    async_backend_t        m_backend   = async_backend_t::threads;
+    std::size_t            m_in_flight = 0;
+
+#ifdef TRICKSTER_IO_URING
+    _internal::io_uring_t m_ring;
+    int                   m_mem_fd = -1;
+    std::vector<iovec>    m_fixed;
+#endif
+
+    std::vector<std::thread>        m_workers;
+    std::mutex                      m_mutex;
+    std::condition_variable         m_wake, m_done;
+    std::deque<async_read_t>        m_pending;
+    std::deque<async_completion_t>  m_completed;
+    bool                            m_stopping = false;
+
+    void worker_loop( ) {
+      constexpr std::size_t           batch = 64;
+      std::vector<async_read_t>       reads;
+      std::vector<read_entry_t>       entries;
+      std::vector<std::size_t>        bytes_read;
+      std::vector<async_completion_t> completions;
+
+      std::unique_lock lock( m_mutex );
+      for ( ;; ) {
+        m_wake.wait( lock, [ & ] { return m_stopping || !m_pending.empty( ); } );
+        if ( m_stopping )
+          return;
+
+        reads.clear( );
+        for ( ; !m_pending.empty( ) && reads.size( ) < batch; m_pending.pop_front( ) )
+          reads.push_back( m_pending.front( ) );
+        lock.unlock( );
+
+        entries.resize( reads.size( ) );
+        bytes_read.assign( reads.size( ), 0 );
+        for ( std::size_t i = 0; i < reads.size( ); i++ )
+          entries[ i ] = { reads[ i ].address, reads[ i ].buffer, reads[ i ].size };
+        const bool accessed = m_process.read_scatter( entries.data( ), entries.size( ), bytes_read.data( ) )
+                                  .has_value( );
+        const int  error    = errno;
+
+        completions.clear( );
+        for ( std::size_t i = 0; i < reads.size( ); i++ ) {
+          const bool failed = !accessed || ( bytes_read[ i ] == 0 && reads[ i ].size != 0 );
+          completions.push_back(
+              { reads[ i ].user_data, bytes_read[ i ], failed ? ( error ? error : EFAULT ) : 0 } );
+        }
+
+        lock.lock( );
+        m_completed.insert( m_completed.end( ), completions.begin( ), completions.end( ) );
+        m_done.notify_all( );
+      }
+    }
+
+    std::size_t take( async_completion_t * out, std::size_t max ) {
+      std::size_t taken = 0;
+#ifdef TRICKSTER_IO_URING
+      if ( m_backend == async_backend_t::io_uring ) {
+        m_ring.reap( [ & ]( const io_uring_cqe & cqe ) {
+          if ( taken == max )
+            return false;
+          const auto bytes_read = cqe.res < 0 ? 0 : static_cast<std::size_t>( cqe.res );
+          out[ taken++ ]        = { cqe.user_data, bytes_read, cqe.res < 0 ? -cqe.res : 0 };
+          return true;
+        } );
+        m_in_flight -= taken;
+        return taken;
+      }
+#endif
+      for ( ; taken < max && !m_completed.empty( ); m_completed.pop_front( ) )
+        out[ taken++ ] = m_completed.front( );
+      m_in_flight -= taken;
+      return taken;
+    }
+
+  public:
+    /**
+     * Create reader.
+     * @param process process to read from.
+     * @param options reader options.
+     */
+    explicit async_reader_t( const process_t & process, const async_reader_options_t & options = { } )
+        : m_process( process ), m_options( options ) {
+      tr_assert( process.is_valid( ), tr_string( "Process is invalid." ) );
+      tr_assert( options.queue_depth != 0, tr_string( "Queue has to hold at least one read." ) );
+
+#ifdef TRICKSTER_IO_URING
+      if ( options.io_uring ) {
+        m_mem_fd = _internal::open_proc_mem( process.get_id( ) );
+        if ( m_mem_fd >= 0 && m_ring.setup( static_cast<unsigned>( options.queue_depth ) ) ) {
+          m_options.queue_depth = std::min<std::size_t>( options.queue_depth, m_ring.entries( ) );
+          m_backend             = async_backend_t::io_uring;
+          return;
+        }
+      }
+#endif
+      for ( std::size_t worker = 0; worker < std::max<std::size_t>( options.threads, 1 ); worker++ )
+        m_workers.emplace_back( [ this ] { worker_loop( ); } );
+    }
+
+    ~async_reader_t( ) {
+#ifdef TRICKSTER_IO_URING
+      // Kernel can still write into buffers of reads in flight, wait for them.
+      if ( m_backend == async_backend_t::io_uring ) {
+        async_completion_t completion;
+        while ( m_in_flight != 0 && m_ring.enter( 1 ) )
+          take( &completion, 1 );
+      }
+      if ( m_mem_fd >= 0 )
+        close( m_mem_fd );
+#endif
+      {
+        std::lock_guard lock( m_mutex );
+        m_stopping = true;
+      }
+      m_wake.notify_all( );
+      for ( auto & worker : m_workers )
+        worker.join( );
+    }
+
+    async_reader_t( const async_reader_t & )             = delete;
+    async_reader_t & operator=( const async_reader_t & ) = delete;
+
+    /**
+     * Get mechanism executing reads.
+     * @return async backend.
+     */
+    [[nodiscard]] async_backend_t backend( ) const noexcept { return m_backend; }
+
+    /**
+     * Get maximum number of reads in flight, io_uring can lower the configured one.
+     * @return queue depth.
+     */
+    [[nodiscard]] std::size_t queue_depth( ) const noexcept { return m_options.queue_depth; }
+
+    /**
+     * Get number of submitted reads whose completions were not taken yet.
+     * @return reads in flight.
+     */
+    [[nodiscard]] std::size_t in_flight( ) const noexcept { return m_in_flight; }
+
+    /**
+     * Register buffers reads are going to target, so io_uring does not map
+     * them on every read. Reads into registered buffers use
+     * IORING_OP_READ_FIXED. No reads may be in flight. Without io_uring this
+     * does nothing.
+     * @param buffers buffers to register.
+     * @param count number of buffers.
+     * @return true if buffers were registered or there is nothing to register them with.
+     */
+    bool register_buffers( const iovec * buffers, std::size_t count ) {
+      tr_assert( m_in_flight == 0, tr_string( "Buffers cannot be registered while reads are in flight." ) );
+#ifdef TRICKSTER_IO_URING
+      if ( m_backend == async_backend_t::io_uring ) {
+        m_fixed.clear( );
+        if ( !m_ring.register_buffers( buffers, static_cast<unsigned>( count ) ) )
+          return false;
+        m_fixed.assign( buffers, buffers + count );
+      }
+#else
+      (void)buffers;
+      (void)count;
+#endif
+      return true;
+    }
+
+    /**
+     * Submit reads, as many as fit into the queue.
+     * @param reads reads to submit, buffers have to stay valid until completion.
+     * @param count number of reads.
+     * @return number of submitted reads.
+     */
+    std::size_t submit( const async_read_t * reads, std::size_t count ) {
+      tr_assert( std::all_of( reads,
+                              reads + count,
+                              []( const async_read_t & read ) { return read.size <= INT32_MAX; } ),
+                 tr_string( "Asynchronous read size exceeds 2 GiB." ) );
+      count = std::min( count, m_options.queue_depth - m_in_flight );
+      if ( count == 0 )
+        return 0;
+
+#ifdef TRICKSTER_IO_URING
+      if ( m_backend == async_backend_t::io_uring ) {
+        for ( std::size_t i = 0; i < count; i++ ) {
+          const auto buffer       = static_cast<std::uint8_t *>( reads[ i ].buffer );
+          int        buffer_index = -1;
+          for ( std::size_t fixed = 0; fixed < m_fixed.size( ) && buffer_index < 0; fixed++ ) {
+            const auto base = static_cast<std::uint8_t *>( m_fixed[ fixed ].iov_base );
+            if ( buffer >= base && buffer + reads[ i ].size <= base + m_fixed[ fixed ].iov_len )
+              buffer_index = static_cast<int>( fixed );
+          }
+          m_ring.queue_read( m_mem_fd, reads[ i ], buffer_index );
+        }
+        // Queued reads belong to the kernel once published, if entering fails they are
+        // submitted again by the next enter and still have to be waited for.
+        m_ring.enter( 0 );
+        m_in_flight += count;
+        return count;
+      }
+#endif
+      {
+        std::lock_guard lock( m_mutex );
+        m_pending.insert( m_pending.end( ), reads, reads + count );
+      }
+      m_wake.notify_all( );
+      m_in_flight += count;
+      return count;
+    }
+
+    /**
+     * Submit read.
+     * @param read read to submit, buffer has to stay valid until completion.
+     * @return true if read was submitted, false if queue is full.
+     */
+    bool submit( const async_read_t & read ) { return submit( &read, 1 ) == 1; }
+
+    /**
+     * Take completions without waiting.
+     * @param out array of max elements receiving completions.
+     * @param max maximum number of completions taken.
+     * @return number of taken completions.
+     */
+    std::size_t poll( async_completion_t * out, std::size_t max ) {
+      if ( m_backend == async_backend_t::threads ) {
+        std::lock_guard lock( m_mutex );
+        return take( out, max );
+      }
+      return take( out, max );
+    }
+
+    /**
+     * Wait for at least min completions (fewer if fewer reads are in flight) and take them.
+     * @param out array of max elements receiving completions.
+     * @param max maximum number of completions taken.
+     * @param min number of completions to wait for.
+     * @return number of taken completions.
+     */
+    std::size_t wait( async_completion_t * out, std::size_t max, std::size_t min = 1 ) {
+      min = std::min( { min, max, m_in_flight } );
+#ifdef TRICKSTER_IO_URING
+      if ( m_backend == async_backend_t::io_uring ) {
+        std::size_t taken = take( out, max );
+        while ( taken < min && m_ring.enter( static_cast<unsigned>( min - taken ) ) )
+          taken += take( out + taken, max - taken );
+        return taken;
+      }
+#endif
+      std::unique_lock lock( m_mutex );
+      m_done.wait( lock, [ & ] { return m_completed.size( ) >= min; } );
+      return take( out, max );
+    }
+  };
+
+  /**
+   * All processes matching a name, discovered in one /proc pass. Processes of
+   * the same binary share parsed ELF images, which are cached by device and
+   * inode. Operations over the group run one process per iteration of a thread
+   * pool loop, and scans started from those iterations are spread across the
+   * same pool by work stealing.
+   */
+  class process_group_t {
+  private:
+    std::string                             m_name;
+    io_backend_t                            m_backend;
+    process_match_t                         m_match;
+    thread_pool_t *                         m_pool;
+    std::vector<std::unique_ptr<process_t>> m_processes;
+
+  public:
+    /**
+     * Attach to all processes with given name.
+     * @param process_name name of the processes.
+     * @param backend mechanism used to access process memory, see process_t.
+     * @param match property of the processes compared with the name.
+     * @param pool thread pool operations run on (default: thread_pool_t::shared()).
+     */
+    explicit process_group_t( std::string_view process_name,
+                              io_backend_t     backend = io_backend_t::vm_readv,
+                              process_match_t  match   = process_match_t::comm,
+                              thread_pool_t *  pool    = nullptr )
+        : m_name( process_name ), m_backend( backend ), m_match( match ),
+          m_pool( pool ? pool : &thread_pool_t::shared( ) ) {
+      refresh( );
+    }
+
+    process_group_t( const process_group_t & )             = delete;
+    process_group_t & operator=( const process_group_t & ) = delete;
+
+    /**
+     * Attach to processes that started matching since the last refresh and
+     * drop the ones that exited. Processes that are still running keep their
+     * process_t objects (and mapped regions), but their indices can change.
+     * @return number of newly attached processes.
+     */
+    std::size_t refresh( ) {
+      std::unordered_map<int, std::unique_ptr<process_t>> attached;
+      for ( auto & process : m_processes )
+        attached.emplace( process->get_id( ), std::move( process ) );
+      m_processes.clear( );
+
+      std::size_t added = 0;
+      for ( const auto pid : _internal::get_pids_by_name( m_name, m_match ) ) {
+        if ( auto process = attached.find( pid ); process != attached.end( ) ) {
+          m_processes.push_back( std::move( process->second ) );
+          continue;
+        }
+        auto process = std::make_unique<process_t>( pid, m_backend );
+        if ( !process->is_valid( ) )
+          continue;
+        m_processes.push_back( std::move( process ) );
+        added++;
+      }
+      return added;
+    }
+
+    /**
+     * Get number of processes in the group.
+     * @return number of attached processes.
+     */
+    [[nodiscard]] std::size_t size( ) const noexcept { return m_processes.size( ); }
+
+    /**
+     * Check if the group has no processes.
+     * @return true if no process is attached.
+     */
+    [[nodiscard]] bool empty( ) const noexcept { return m_processes.empty( ); }
+
+    /**
+     * Get process by index.
+     * @param index process index, less than size().
+     * @return process.
+     */
+    [[nodiscard]] process_t & operator[]( std::size_t index ) noexcept { return *m_processes[ index ]; }
+
+    /**
+     * Get process by index.
+     * @param index process index, less than size().
+     * @return process.
+     */
+    [[nodiscard]] const process_t & operator[]( std::size_t index ) const noexcept {
+      return *m_processes[ index ];
+    }
+
+    /**
+     * Get thread pool operations of the group run on.
+     * @return thread pool.
+     */
+    [[nodiscard]] thread_pool_t & pool( ) const noexcept { return *m_pool; }
+
+    /**
+     * Call callback for every process, in parallel.
+     * @param callback called with process and its index in the group.
+     */
+    template <typename F> void for_each( F && callback ) {
+      m_pool->parallel_for( m_processes.size( ), [ & ]( std::size_t index, std::size_t ) {
+        callback( *m_processes[ index ], index );
+      } );
+    }
+
+    /**
+     * Map memory regions of every process.
+     * @return number of processes with at least one mapped region.
+     */
+    std::size_t map_memory_regions( ) {
+      std::atomic<std::size_t> mapped { 0 };
+      for_each( [ & ]( process_t & process, std::size_t ) {
+        process.map_memory_regions( );
+        if ( !process.get_memory_regions( ).empty( ) )
+          mapped.fetch_add( 1, std::memory_order_relaxed );
+      } );
+      return mapped.load( );
+    }
+
+    /**
+     * Scan memory of every process for pattern, regions have to be mapped.
+     * @param pattern parsed signature.
+     * @param options scan options, scans run on the group's pool unless other is set.
+     * @return matches of every process, indexed like the group.
+     */
+    [[nodiscard]] std::vector<std::vector<std::uintptr_t>> find_pattern( const pattern_t & pattern,
+                                                                         scan_options_t    options = { } ) {
+      if ( !options.pool )
+        options.pool = m_pool;
+
+      std::vector<std::vector<std::uintptr_t>> matches( m_processes.size( ) );
+      for_each( [ & ]( process_t & process, std::size_t index ) {
+        matches[ index ] = process.find_pattern( pattern, options );
+      } );
+      return matches;
+    }
+
+    /**
+     * Resolve symbol in every process, regions have to be mapped. Every
+     * distinct module file is parsed once for the whole group.
+     * @param module filename or full path of the module.
+     * @param symbol symbol name.
+     * @return address of the symbol in every process, indexed like the group.
+     */
+    [[nodiscard]] std::vector<std::optional<std::uintptr_t>> resolve_symbol( std::string_view module,
+                                                                             std::string_view symbol ) {
+      std::vector<std::optional<std::uintptr_t>> addresses( m_processes.size( ) );
+      for_each( [ & ]( process_t & process, std::size_t index ) {
+        addresses[ index ] = process.resolve_symbol( module, symbol );
+      } );
+      return addresses;
+    }
+
+    /**
+     * Poll watchers of processes in parallel, see watcher_t::poll.
+     * @param watchers watchers, each of a different process.
+     * @return result of every poll, indexed like watchers.
+     */
+    std::vector<std::optional<std::size_t>> poll( const std::vector<watcher_t *> & watchers ) {
+      std::vector<std::optional<std::size_t>> changes( watchers.size( ) );
+      m_pool->parallel_for( watchers.size( ), [ & ]( std::size_t index, std::size_t ) {
+        changes[ index ] = watchers[ index ]->poll( );
+      } );
+      return changes;
     }
   };
 } // namespace tr
@@ -0,0 +1,117 @@
+#include <tr.hpp>
+
+#include <cstdio>
+
+namespace {
+  using kind_t = tr::reference_kind_t;
+
+  struct encoding_t {
+    const char *              text;
+    std::vector<std::uint8_t> bytes;
+    std::uint8_t              length, reference_offset;
+    kind_t                    kind;
+  };
+
+  // Lengths as reported by objdump, reference offset is 0 for instructions referencing nothing.
+  const encoding_t encodings[] = {
+    { "nop", { 0x90 }, 1, 0, kind_t::call },
+    { "ret", { 0xC3 }, 1, 0, kind_t::call },
+    { "ret 8", { 0xC2, 0x08, 0x00 }, 3, 0, kind_t::call },
+    { "syscall", { 0x0F, 0x05 }, 2, 0, kind_t::call },
+    { "endbr64", { 0xF3, 0x0F, 0x1E, 0xFA }, 4, 0, kind_t::call },
+    { "mov rbp, rsp", { 0x48, 0x89, 0xE5 }, 3, 0, kind_t::call },
+    { "sub rsp, 0x10", { 0x48, 0x83, 0xEC, 0x10 }, 4, 0, kind_t::call },
+    { "sub rsp, 0x100", { 0x48, 0x81, 0xEC, 0x00, 0x01, 0x00, 0x00 }, 7, 0, kind_t::call },
+    { "movabs rax, imm64", { 0x48, 0xB8, 1, 2, 3, 4, 5, 6, 7, 8 }, 10, 0, kind_t::call },
+    { "mov eax, imm32", { 0xB8, 1, 2, 3, 4 }, 5, 0, kind_t::call },
+    { "mov ax, imm16", { 0x66, 0xB8, 1, 2 }, 4, 0, kind_t::call },
+    { "call r12", { 0x41, 0xFF, 0xD4 }, 3, 0, kind_t::call },
+    { "mov rax, [rsp + 8]", { 0x48, 0x8B, 0x44, 0x24, 0x08 }, 5, 0, kind_t::call },
+    { "mov eax, [abs32]", { 0x8B, 0x04, 0x25, 1, 2, 3, 4 }, 7, 0, kind_t::call },
+    { "mov eax, [rbx + disp32]", { 0x8B, 0x83, 1, 2, 3, 4 }, 6, 0, kind_t::call },
+    { "imul eax, eax, 8", { 0x6B, 0xC0, 0x08 }, 3, 0, kind_t::call },
+    { "imul rax, rax, imm32", { 0x48, 0x69, 0xC0, 1, 2, 3, 4 }, 7, 0, kind_t::call },
+    { "test cl, 1", { 0xF6, 0xC1, 0x01 }, 3, 0, kind_t::call },
+    { "test ecx, imm32", { 0xF7, 0xC1, 1, 2, 3, 4 }, 6, 0, kind_t::call },
+    { "neg eax", { 0xF7, 0xD8 }, 2, 0, kind_t::call },
+    { "xchg ax, ax", { 0x66, 0x90 }, 2, 0, kind_t::call },
+    { "nopw [rax + rax]", { 0x66, 0x0F, 0x1F, 0x44, 0x00, 0x00 }, 6, 0, kind_t::call },
+    { "nopl [rax + disp32]", { 0x0F, 0x1F, 0x80, 0, 0, 0, 0 }, 7, 0, kind_t::call },
+    { "nopw cs:[rax + rax]", { 0x66, 0x2E, 0x0F, 0x1F, 0x84, 0x00, 0, 0, 0, 0 }, 10, 0, kind_t::call },
+    { "jmp rel8", { 0xEB, 0x10 }, 2, 0, kind_t::call },
+    { "je rel8", { 0x74, 0x05 }, 2, 0, kind_t::call },
+
+    // 0F 38 and 0F 3A maps.
+    { "pshufb xmm0, xmm1", { 0x66, 0x0F, 0x38, 0x00, 0xC1 }, 5, 0, kind_t::call },
+    { "palignr xmm0, xmm1, 8", { 0x66, 0x0F, 0x3A, 0x0F, 0xC1, 0x08 }, 6, 0, kind_t::call },
+    { "pshufb xmm0, [rip + x]", { 0x66, 0x0F, 0x38, 0x00, 0x05, 1, 2, 3, 4 }, 9, 5, kind_t::memory },
+
+    // VEX and EVEX.
+    { "vzeroupper", { 0xC5, 0xF8, 0x77 }, 3, 0, kind_t::call },
+    { "vpshufb ymm0, ymm0, ymm1", { 0xC4, 0xE2, 0x7D, 0x00, 0xC1 }, 5, 0, kind_t::call },
+    { "vpalignr ymm0, ymm0, ymm1, 8", { 0xC4, 0xE3, 0x7D, 0x0F, 0xC1, 0x08 }, 6, 0, kind_t::call },
+    { "vmovdqa ymm0, [rip + x]", { 0xC5, 0xFD, 0x6F, 0x05, 1, 2, 3, 4 }, 8, 4, kind_t::memory },
+    { "vmovaps zmm0, zmm1", { 0x62, 0xF1, 0x7C, 0x48, 0x28, 0xC1 }, 6, 0, kind_t::call },
+    { "vmovups zmm0, [rip + x]", { 0x62, 0xF1, 0x7C, 0x48, 0x10, 0x05, 1, 2, 3, 4 }, 10, 6, kind_t::memory },
+
+    // rel32 branches.
+    { "call rel32", { 0xE8, 1, 2, 3, 4 }, 5, 1, kind_t::call },
+    { "jmp rel32", { 0xE9, 1, 2, 3, 4 }, 5, 1, kind_t::jump },
+    { "je rel32", { 0x0F, 0x84, 1, 2, 3, 4 }, 6, 2, kind_t::conditional_jump },
+    { "jg rel32", { 0x0F, 0x8F, 1, 2, 3, 4 }, 6, 2, kind_t::conditional_jump },
+
+    // RIP-relative operands.
+    { "lea rax, [rip + x]", { 0x48, 0x8D, 0x05, 1, 2, 3, 4 }, 7, 3, kind_t::lea },
+    { "lea r15, [rip + x]", { 0x4C, 0x8D, 0x3D, 1, 2, 3, 4 }, 7, 3, kind_t::lea },
+    { "mov rax, [rip + x]", { 0x48, 0x8B, 0x05, 1, 2, 3, 4 }, 7, 3, kind_t::mov },
+    { "mov [rip + x], eax", { 0x89, 0x05, 1, 2, 3, 4 }, 6, 2, kind_t::mov },
+    { "mov dword [rip + x], imm32", { 0xC7, 0x05, 1, 2, 3, 4, 5, 6, 7, 8 }, 10, 2, kind_t::mov },
+    { "mov word [rip + x], imm16", { 0x66, 0xC7, 0x05, 1, 2, 3, 4, 5, 6 }, 9, 3, kind_t::mov },
+    { "call [rip + x]", { 0xFF, 0x15, 1, 2, 3, 4 }, 6, 2, kind_t::memory },
+    { "jmp [rip + x]", { 0xFF, 0x25, 1, 2, 3, 4 }, 6, 2, kind_t::memory },
+    { "cmp byte [rip + x], 0", { 0x80, 0x3D, 1, 2, 3, 4, 0 }, 7, 2, kind_t::memory },
+    { "cmp qword [rip + x], imm32", { 0x48, 0x81, 0x3D, 1, 2, 3, 4, 5, 6, 7, 8 }, 11, 3, kind_t::memory },
+    { "movss xmm0, [rip + x]", { 0xF3, 0x0F, 0x10, 0x05, 1, 2, 3, 4 }, 8, 4, kind_t::memory },
+  };
+} // namespace
+
+int main( ) {
+  int failures = 0;
+  for ( const auto & encoding : encodings ) {
+    // Trailing bytes must not change the result.
+    auto code = encoding.bytes;
+    code.resize( 15, 0xCC );
+
+    const auto instruction = tr::_internal::decode_x86_64( code.data( ), code.size( ) );
+    const bool kind_ok     = encoding.reference_offset == 0 || instruction.kind == encoding.kind;
+    if ( instruction.length != encoding.length || instruction.reference_offset != encoding.reference_offset ||
+         !kind_ok ) {
+      printf( "FAILED: %s decoded as length %u, reference offset %u, kind %u\n",
+              encoding.text,
+              instruction.length,
+              instruction.reference_offset,
+              static_cast<unsigned>( instruction.kind ) );
+      failures++;
+    }
+
+    // Truncated instruction is not decoded.
+    const auto truncated = tr::_internal::decode_x86_64( encoding.bytes.data( ), encoding.bytes.size( ) - 1 );
+    if ( truncated.length != 0 ) {
+      printf( "FAILED: truncated %s decoded as length %u\n", encoding.text, truncated.length );
+      failures++;
+    }
+  }
+
+  // Backward call, displacement is sign extended.
+  const std::uint8_t call[] = { 0xE8, 0xF0, 0xFF, 0xFF, 0xFF };
+  const auto         reference =
+      tr::_internal::reference_of( tr::_internal::decode_x86_64( call, sizeof( call ) ), call, 0x1000 );
+  if ( !reference || reference->target != 0x1000 + 5 - 0x10 || reference->kind != kind_t::call ) {
+    printf( "FAILED: backward call target\n" );
+    failures++;
+  }
+
+  if ( failures == 0 )
+    printf( "All decoder checks passed.\n" );
+  return failures == 0 ? 0 : 1;
+}
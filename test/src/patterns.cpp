@@ -0,0 +1,142 @@
+#include <tr.hpp>
+
+#include <cstdio>
+#include <random>
+
+namespace {
+  int failures = 0;
+
+  void check( bool condition, const char * what ) {
+    if ( !condition ) {
+      printf( "FAILED: %s\n", what );
+      failures++;
+    }
+  }
+
+  // Byte by byte reference every kernel is compared with.
+  std::vector<std::size_t>
+  reference( const std::uint8_t * data, std::size_t size, const tr::pattern_t & pattern ) {
+    std::vector<std::size_t> matches;
+    for ( std::size_t offset = 0; offset + pattern.size( ) <= size && pattern.size( ) != 0; offset++ ) {
+      bool matched = true;
+      for ( std::size_t i = 0; i < pattern.size( ) && matched; i++ )
+        matched = ( ( data[ offset + i ] ^ pattern.bytes[ i ] ) & pattern.mask[ i ] ) == 0;
+      if ( matched )
+        matches.push_back( offset );
+    }
+    return matches;
+  }
+
+  template <typename K> std::vector<std::size_t> collect( K && kernel, std::size_t limit = 0 ) {
+    std::vector<std::size_t> matches;
+    kernel( [ & ]( std::size_t offset ) {
+      matches.push_back( offset );
+      return limit == 0 || matches.size( ) < limit;
+    } );
+    return matches;
+  }
+
+  /**
+   * Buffer ending right before an inaccessible page, so reads past the end fault.
+   */
+  class guarded_buffer_t {
+  private:
+    std::uint8_t * m_mapping = nullptr;
+    std::size_t    m_mapping_size = 0, m_size = 0;
+
+  public:
+    explicit guarded_buffer_t( std::size_t size ) : m_size( size ) {
+      const auto page = static_cast<std::size_t>( sysconf( _SC_PAGESIZE ) );
+      m_mapping_size  = ( size + page - 1 ) / page * page + page;
+      m_mapping       = static_cast<std::uint8_t *>(
+          mmap( nullptr, m_mapping_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0 ) );
+      mprotect( m_mapping + m_mapping_size - page, page, PROT_NONE );
+    }
+
+    ~guarded_buffer_t( ) { munmap( m_mapping, m_mapping_size ); }
+
+    guarded_buffer_t( const guarded_buffer_t & )             = delete;
+    guarded_buffer_t & operator=( const guarded_buffer_t & ) = delete;
+
+    [[nodiscard]] std::uint8_t * data( ) const noexcept {
+      return m_mapping + m_mapping_size - static_cast<std::size_t>( sysconf( _SC_PAGESIZE ) ) - m_size;
+    }
+  };
+} // namespace
+
+int main( ) {
+  // Leading and trailing wildcards, single concrete byte, distant anchors, patterns longer than a vector.
+  constexpr const char * signatures[] = {
+    "AA",
+    "AA BB",
+    "?? AA BB",
+    "AA BB ??",
+    "?? ?? AA ?? ??",
+    "AA ?? ?? ?? BB",
+    "00 AA ?? 00",
+    "BB ?? ?? ?? ?? ?? ?? ?? ?? ?? ?? ?? ?? ?? ?? ?? ?? ?? AA",
+    "AA BB AA BB AA BB AA BB AA BB AA BB AA BB AA BB AA",
+    "?? AA BB 00 AA BB 00 AA BB 00 AA BB 00 AA BB 00 AA BB 00 AA BB 00 AA BB 00 AA BB 00 AA BB 00 AA ??",
+  };
+  constexpr std::uint8_t alphabet[] = { 0xAA, 0xBB, 0x00, 0x48 };
+
+  std::mt19937             random( 1337 );
+  std::vector<std::size_t> sizes;
+  for ( std::size_t size = 0; size <= 130; size++ )
+    sizes.push_back( size );
+  for ( const std::size_t size : { 255, 256, 257, 1000, 4095, 4096, 4097, 65537 } )
+    sizes.push_back( size );
+
+  for ( const auto size : sizes ) {
+    for ( int round = 0; round < 4; round++ ) {
+      guarded_buffer_t buffer( size );
+      const auto       data = buffer.data( );
+      for ( std::size_t i = 0; i < size; i++ )
+        data[ i ] = round % 2 == 0 ? alphabet[ random( ) % sizeof( alphabet ) ]
+                                   : static_cast<std::uint8_t>( random( ) );
+
+      for ( const auto signature : signatures ) {
+        const auto pattern  = *tr::pattern_t::parse( signature );
+        const auto expected = reference( data, size, pattern );
+
+        const auto scalar = collect( [ & ]( auto on_match ) {
+          tr::_internal::match_pattern_scalar( data, size, pattern, 0, on_match );
+        } );
+        check( scalar == expected, "scalar kernel matches reference" );
+
+#ifdef TRICKSTER_X86_SIMD
+        const auto sse2 = collect( [ & ]( auto on_match ) {
+          tr::_internal::match_pattern_sse2( data, size, pattern, on_match );
+        } );
+        check( sse2 == expected, "sse2 kernel matches reference" );
+
+        if ( tr::_internal::cpu_has_avx2( ) ) {
+          const auto avx2 = collect( [ & ]( auto on_match ) {
+            tr::_internal::match_pattern_avx2( data, size, pattern, on_match );
+          } );
+          check( avx2 == expected, "avx2 kernel matches reference" );
+        }
+#endif
+
+        // Stopping after the first matches has to yield their prefix.
+        const auto first = collect(
+            [ & ]( auto on_match ) { tr::_internal::match_pattern( data, size, pattern, on_match ); }, 3 );
+        check( first.size( ) == std::min<std::size_t>( 3, expected.size( ) ) &&
+                   std::equal( first.begin( ), first.end( ), expected.begin( ) ),
+               "stopped search returns first matches" );
+
+        if ( failures != 0 ) {
+          printf( "size %zu, round %d, pattern %s\n", size, round, signature );
+          return 1;
+        }
+      }
+    }
+  }
+
+#ifdef TRICKSTER_X86_SIMD
+  if ( !tr::_internal::cpu_has_avx2( ) )
+    printf( "AVX2 is not supported by this CPU, its kernel was not checked.\n" );
+#endif
+  printf( "All pattern checks passed.\n" );
+  return 0;
+}
@@ -0,0 +1,144 @@
+#include <tr.hpp>
+
+#include <cstdio>
+#include <signal.h>
+
+namespace {
+  int failures = 0;
+
+  void check( bool condition, const char * what ) {
+    if ( !condition ) {
+      printf( "FAILED: %s\n", what );
+      failures++;
+    }
+  }
+
+  std::vector<std::uint8_t> load( const std::filesystem::path & path ) {
+    std::ifstream file( path, std::ios::binary );
+    return { std::istreambuf_iterator<char>( file ), std::istreambuf_iterator<char>( ) };
+  }
+
+  void store( const std::filesystem::path & path, const std::vector<std::uint8_t> & contents ) {
+    std::ofstream file( path, std::ios::binary | std::ios::trunc );
+    file.write( reinterpret_cast<const char *>( contents.data( ) ),
+                static_cast<std::streamsize>( contents.size( ) ) );
+  }
+
+  template <typename T> T & field_at( std::vector<std::uint8_t> & contents, std::uint64_t offset ) {
+    return *reinterpret_cast<T *>( contents.data( ) + offset );
+  }
+
+  // Corrupt copy of the snapshot and check it is rejected.
+  template <typename F>
+  void check_rejected( const std::vector<std::uint8_t> & original,
+                       const std::filesystem::path &     path,
+                       const char *                      what,
+                       F &&                              corrupt ) {
+    auto contents = original;
+    corrupt( contents );
+    store( path, contents );
+
+    tr::snapshot_t snapshot;
+    check( !snapshot.open( path ), what );
+  }
+} // namespace
+
+int main( ) {
+  const auto page_size = static_cast<std::size_t>( sysconf( _SC_PAGESIZE ) );
+  constexpr std::size_t pages = 16, changed = 5;
+
+  auto buffer = static_cast<std::uint8_t *>(
+      mmap( nullptr, pages * page_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0 ) );
+  for ( std::size_t i = 0; i < pages * page_size; i++ )
+    buffer[ i ] = static_cast<std::uint8_t>( i * 31 );
+
+  const auto child = fork( );
+  if ( child == 0 ) {
+    for ( ;; )
+      pause( );
+  }
+
+  const auto directory = std::filesystem::temp_directory_path( );
+  const auto first     = directory / ( "trtest_before_" + std::to_string( child ) + ".snap" );
+  const auto second    = directory / ( "trtest_after_" + std::to_string( child ) + ".snap" );
+  const auto corrupted = directory / ( "trtest_corrupted_" + std::to_string( child ) + ".snap" );
+
+  tr::process_t process( child );
+  process.map_memory_regions( );
+  check( process.write_snapshot( first ), "first snapshot written" );
+
+  const auto address = reinterpret_cast<std::uintptr_t>( buffer ) + changed * page_size;
+  check( process.write_memory<std::uint32_t>( address + 8, 0xDEADBEEF ).has_value( ),
+         "child memory written" );
+  check( process.write_snapshot( second ), "second snapshot written" );
+  kill( child, SIGKILL );
+  waitpid( child, nullptr, 0 );
+
+  tr::snapshot_t before, after;
+  check( before.open( first ) && after.open( second ), "snapshots opened" );
+  if ( before.is_open( ) && after.is_open( ) ) {
+    check( before.get_id( ) == child, "snapshot pid" );
+    check( before.at( address ) && before.at( address )[ 8 ] == buffer[ changed * page_size + 8 ],
+           "old contents in first snapshot" );
+
+    std::uint32_t value = 0;
+    if ( after.at( address ) )
+      std::memcpy( &value, after.at( address ) + 8, sizeof( value ) );
+    check( value == 0xDEADBEEF, "new contents in second snapshot" );
+
+    const auto covers = [ & ]( std::uintptr_t target ) {
+      const auto changes = tr::utils::diff_snapshots( before, after );
+      return std::any_of( changes.begin( ), changes.end( ), [ & ]( const tr::snapshot_change_t & change ) {
+        return target >= change.address && target < change.address + change.size;
+      } );
+    };
+    check( covers( address ), "diff contains written page" );
+    check( !covers( address - page_size ) && !covers( address + page_size ), "diff skips unchanged pages" );
+  }
+  before.close( );
+  after.close( );
+
+  const auto original = load( first );
+  const auto header   = *reinterpret_cast<const tr::_internal::snapshot_header_t *>( original.data( ) );
+  const auto region   = [ & ]( std::size_t index ) {
+    return header.regions_offset + index * sizeof( tr::snapshot_region_t );
+  };
+
+  check( header.region_count >= 2 && header.data_page_count > 0, "snapshot has regions and data" );
+  if ( header.region_count >= 2 && header.data_page_count > 0 ) {
+    check_rejected( original, corrupted, "truncated file rejected", []( auto & contents ) {
+      contents.resize( contents.size( ) - 1 );
+    } );
+    check_rejected( original, corrupted, "bad magic rejected", []( auto & contents ) {
+      contents[ 0 ] ^= 0xFF;
+    } );
+    check_rejected( original, corrupted, "overflowing region count rejected", []( auto & contents ) {
+      field_at<tr::_internal::snapshot_header_t>( contents, 0 ).region_count = UINT32_MAX;
+    } );
+    check_rejected( original, corrupted, "empty region rejected", [ & ]( auto & contents ) {
+      auto & entry = field_at<tr::snapshot_region_t>( contents, region( 0 ) );
+      entry.end    = entry.start;
+    } );
+    check_rejected( original, corrupted, "unsorted regions rejected", [ & ]( auto & contents ) {
+      std::swap( field_at<tr::snapshot_region_t>( contents, region( 0 ) ),
+                 field_at<tr::snapshot_region_t>( contents, region( 1 ) ) );
+    } );
+    check_rejected( original, corrupted, "overflowing first page rejected", [ & ]( auto & contents ) {
+      field_at<tr::snapshot_region_t>( contents, region( 0 ) ).first_page = UINT64_MAX - 1;
+    } );
+    check_rejected( original, corrupted, "path outside of path table rejected", [ & ]( auto & contents ) {
+      field_at<tr::snapshot_region_t>( contents, region( 0 ) ).path_offset = UINT32_MAX;
+    } );
+    check_rejected( original, corrupted, "page data outside of file rejected", [ & ]( auto & contents ) {
+      field_at<tr::snapshot_page_t>( contents, header.pages_offset ).data = header.data_page_count;
+    } );
+  }
+
+  std::filesystem::remove( first );
+  std::filesystem::remove( second );
+  std::filesystem::remove( corrupted );
+
+  if ( failures == 0 )
+    printf( "All snapshot checks passed.\n" );
+  return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,129 @@
+#include <tr.hpp>
+
+#include <cstdio>
+#include <signal.h>
+
+namespace {
+  int failures = 0;
+
+  void check( bool condition, const char * what ) {
+    if ( !condition ) {
+      printf( "FAILED: %s\n", what );
+      failures++;
+    }
+  }
+
+  constexpr std::size_t   chunk_size = 1 << 16, slots = chunk_size / sizeof( std::uint32_t ), blocks = 4;
+  constexpr std::uint32_t magic      = 0x7A3C91E5;
+} // namespace
+
+int main( ) {
+  // Inaccessible pages around the buffer make it a region of its own, so blocks start at the buffer.
+  const auto page_size = static_cast<std::size_t>( sysconf( _SC_PAGESIZE ) );
+  const auto mapping   = static_cast<std::uint8_t *>( mmap( nullptr,
+                                                          blocks * chunk_size + 2 * page_size,
+                                                          PROT_READ | PROT_WRITE,
+                                                          MAP_PRIVATE | MAP_ANONYMOUS,
+                                                          -1,
+                                                          0 ) );
+  mprotect( mapping, page_size, PROT_NONE );
+  mprotect( mapping + page_size + blocks * chunk_size, page_size, PROT_NONE );
+  const auto buffer = reinterpret_cast<std::uint32_t *>( mapping + page_size );
+
+  // Block 0 is 1 candidate above the dense threshold, block 1 right at it, block 2 is sparse and block 3
+  // has no candidates.
+  const std::size_t            counts[ blocks ] = { slots / 32 + 1, slots / 32, 16, 0 };
+  std::vector<std::uint32_t *> hits[ blocks ];
+  for ( std::size_t block = 0; block < blocks; block++ ) {
+    for ( std::size_t i = 0; i < counts[ block ]; i++ ) {
+      hits[ block ].push_back( buffer + block * slots + i * ( slots / counts[ block ] ) );
+      *hits[ block ].back( ) = magic;
+    }
+  }
+
+  const auto child = fork( );
+  if ( child == 0 ) {
+    for ( ;; )
+      pause( );
+  }
+
+  tr::process_t process( child );
+  process.map_memory_regions( );
+
+  tr::value_scan_options_t options;
+  options.chunk_size = chunk_size;
+  tr::value_scanner_t<std::uint32_t> scanner( process, options );
+
+  const auto                  begin = reinterpret_cast<std::uintptr_t>( buffer );
+  std::vector<std::uintptr_t> expected;
+  const auto survivors = [ & ] {
+    std::vector<std::uintptr_t> result;
+    for ( const auto address : scanner.addresses( ) )
+      if ( address >= begin && address < begin + blocks * chunk_size )
+        result.push_back( address );
+    return result;
+  };
+  const auto write = [ & ]( std::uint32_t * hit, std::uint32_t value ) {
+    check( process.write_memory<std::uint32_t>( reinterpret_cast<std::uintptr_t>( hit ), value ).has_value( ),
+           "child memory written" );
+  };
+  const auto address = []( std::uint32_t * hit ) { return reinterpret_cast<std::uintptr_t>( hit ); };
+
+  scanner.first_scan( tr::scan_condition_t::equal, magic );
+  for ( const auto & block : hits )
+    for ( const auto hit : block )
+      expected.push_back( address( hit ) );
+  check( survivors( ) == expected, "first scan finds every value in dense and sparse blocks" );
+
+  // Dense block drops to the threshold and switches to offsets.
+  write( hits[ 0 ][ 7 ], magic + 1 );
+  scanner.next_scan( tr::scan_condition_t::unchanged );
+  expected.erase( std::find( expected.begin( ), expected.end( ), address( hits[ 0 ][ 7 ] ) ) );
+  check( survivors( ) == expected, "unchanged scan drops written value" );
+
+  // Every other value of block 1 and a few of block 2 change.
+  expected.clear( );
+  for ( std::size_t i = 0; i < hits[ 1 ].size( ); i += 2 ) {
+    write( hits[ 1 ][ i ], magic + static_cast<std::uint32_t>( i ) + 1 );
+    expected.push_back( address( hits[ 1 ][ i ] ) );
+  }
+  for ( std::size_t i = 0; i < 4; i++ ) {
+    write( hits[ 2 ][ i ], magic - 1 );
+    expected.push_back( address( hits[ 2 ][ i ] ) );
+  }
+  scanner.next_scan( tr::scan_condition_t::changed );
+  check( survivors( ) == expected, "changed scan keeps written values" );
+
+  // Half of the remaining candidates increase, the others decrease.
+  expected.clear( );
+  for ( std::size_t i = 0; i < hits[ 1 ].size( ); i += 2 ) {
+    const bool increase = i % 4 == 0;
+    write( hits[ 1 ][ i ], increase ? magic + 0x10000 : magic - 0x10000 );
+    if ( increase )
+      expected.push_back( address( hits[ 1 ][ i ] ) );
+  }
+  for ( std::size_t i = 0; i < 4; i++ ) {
+    write( hits[ 2 ][ i ], i < 2 ? magic : magic - 2 );
+    if ( i < 2 )
+      expected.push_back( address( hits[ 2 ][ i ] ) );
+  }
+  scanner.next_scan( tr::scan_condition_t::increased );
+  check( survivors( ) == expected, "increased scan keeps increased values" );
+
+  bool values_ok = true;
+  scanner.for_each( [ & ]( std::uintptr_t candidate, std::uint32_t value ) {
+    if ( candidate >= address( hits[ 2 ][ 0 ] ) && candidate < begin + blocks * chunk_size )
+      values_ok = values_ok && value == magic;
+    else if ( candidate >= begin && candidate < begin + blocks * chunk_size )
+      values_ok = values_ok && value == magic + 0x10000;
+  } );
+  check( values_ok, "candidates hold values read by the last scan" );
+
+  kill( child, SIGKILL );
+  waitpid( child, nullptr, 0 );
+  munmap( mapping, blocks * chunk_size + 2 * page_size );
+
+  if ( failures == 0 )
+    printf( "All value scanner checks passed.\n" );
+  return failures == 0 ? 0 : 1;
+}